@@ -0,0 +1,310 @@
+// Microbenchmarks (Google Benchmark) de chaque étape du pipeline de mesure
+// Scènes synthétiques pied + vrai QR (QRCodeEncoder) à 1, 3, 12 et 48 MP.
+// Construction: cmake -DNATIVE_OPENCV_BENCHMARKS=ON (nécessite libbenchmark), puis:
+//   ./pipeline_benchmark --benchmark_out=pipeline.json --benchmark_out_format=json 2>/dev/null
+// Filtrer: --benchmark_filter='BM_Extreme.*' ; les journaux natifs partent sur stderr.
+// Images temporaires (étapes sur fichier): $TMPDIR, /tmp par défaut.
+
+#include "../native_opencv.cpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+namespace {
+
+const double kBenchmarkQRSizeCm = 3.0;
+
+struct SyntheticScene {
+    cv::Mat bgr;
+    cv::Mat gray;
+    std::string path;                          // JPEG de la scène pour les exports sur fichier
+    cv::Mat straight_qrcode;
+    std::vector<std::vector<cv::Point>> contours;
+    size_t foot_idx = 0;
+    cv::Mat component_stats;                   // statistiques des régions du masque
+    cv::Mat component_centroids;
+    RobustCalibrationData calibration;
+};
+
+cv::Size sceneSize(int megapixels) {
+    switch (megapixels) {
+        case 1: return cv::Size(1152, 864);
+        case 3: return cv::Size(2048, 1536);
+        case 12: return cv::Size(4000, 3000);
+        default: return cv::Size(8000, 6000);
+    }
+}
+
+// Fond clair bruité, pied sombre (plante + orteils) et QR imprimé avec sa marge blanche
+cv::Mat makeFootScene(const cv::Size& size) {
+    cv::Mat scene(size, CV_8UC3, cv::Scalar(205, 210, 215));
+    int w = size.width, h = size.height;
+    cv::Scalar skin(60, 80, 110);
+
+    cv::Point sole_center(w / 2, h * 58 / 100);
+    cv::Size sole_axes(w * 11 / 100, h * 33 / 100);
+    cv::ellipse(scene, sole_center, sole_axes, 0, 0, 360, skin, -1);
+    int toe_y = sole_center.y - sole_axes.height + h / 40;
+    for (int toe = 0; toe < 5; toe++) {
+        int radius = (toe == 0 ? h / 28 : h / 45);
+        int x = sole_center.x - sole_axes.width * 3 / 4 + toe * sole_axes.width * 3 / 8;
+        cv::circle(scene, cv::Point(x, toe_y - radius / 2), radius, skin, -1);
+    }
+
+    cv::Mat qr;
+    cv::Ptr<cv::QRCodeEncoder> encoder = cv::QRCodeEncoder::create();
+    encoder->encode("FOOT-CALIBRATION-3CM", qr);
+    int side = std::min(w, h) / 6;
+    cv::Mat qr_scaled;
+    cv::resize(qr, qr_scaled, cv::Size(side, side), 0, 0, cv::INTER_NEAREST);
+    cv::Mat qr_bgr;
+    cv::cvtColor(qr_scaled, qr_bgr, cv::COLOR_GRAY2BGR);
+    int margin = side / 8;
+    cv::Rect paper(w / 12, h / 12, side + 2 * margin, side + 2 * margin);
+    scene(paper).setTo(cv::Scalar(255, 255, 255));
+    cv::Mat qr_area = scene(cv::Rect(paper.x + margin, paper.y + margin, side, side));
+    qr_bgr.copyTo(qr_area);
+
+    cv::Mat noise(size, CV_8UC3);
+    cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(6));
+    cv::add(scene, noise, scene);
+    return scene;
+}
+
+// Scènes construites une seule fois par taille, hors des boucles chronométrées
+const SyntheticScene& sceneFor(int megapixels) {
+    static std::map<int, SyntheticScene> scenes;
+    auto found = scenes.find(megapixels);
+    if (found != scenes.end()) return found->second;
+
+    SyntheticScene& scene = scenes[megapixels];
+    scene.bgr = makeFootScene(sceneSize(megapixels));
+    cv::cvtColor(scene.bgr, scene.gray, cv::COLOR_BGR2GRAY);
+
+    const char* tmp = std::getenv("TMPDIR");
+    scene.path = std::string(tmp != nullptr ? tmp : "/tmp") + "/pipeline_benchmark_" +
+                 std::to_string(megapixels) + "mp.jpg";
+    cv::imwrite(scene.path, scene.bgr, {cv::IMWRITE_JPEG_QUALITY, 95});
+
+    cv::QRCodeDetector detector;
+    detector.detectAndDecode(scene.bgr, cv::noArray(), scene.straight_qrcode);
+
+    PipelineWorkspace workspace;
+    scene.calibration = detectRobustQRCalibrationWith(workspace, scene.bgr, kBenchmarkQRSizeCm);
+    const AdaptiveParams& params = workspace.adaptiveParams(scene.gray.size());
+    segmentFootAdaptive(workspace, scene.gray, params, scene.foot_idx);
+    scene.contours = workspace.contours;
+    scene.component_stats = workspace.component_stats.clone();
+    scene.component_centroids = workspace.component_centroids.clone();
+    return scene;
+}
+
+void setSceneCounters(benchmark::State& state, const SyntheticScene& scene) {
+    state.counters["megapixels"] = scene.gray.total() / 1e6;
+}
+
+void BM_EstimateQRModules(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    if (scene.straight_qrcode.empty()) {
+        state.SkipWithError("QR non décodé sur la scène synthétique");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(estimateQRModules(scene.straight_qrcode));
+    }
+    setSceneCounters(state, scene);
+}
+
+void BM_DetectRobustQRCalibration(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        RobustCalibrationData calibration = detectRobustQRCalibration(scene.bgr, kBenchmarkQRSizeCm);
+        benchmark::DoNotOptimize(calibration.pixels_per_cm);
+    }
+    setSceneCounters(state, scene);
+    state.counters["calibrated"] = scene.calibration.is_calibrated ? 1 : 0;
+}
+
+// Calibration par trame une fois le QR suivi: scène décalée de quelques pixels d'une trame à l'autre
+void BM_QRCornerTracking(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    cv::Mat shifted;
+    cv::Matx23d shift(1, 0, 3, 0, 1, 2);
+    cv::warpAffine(scene.gray, shifted, shift, scene.gray.size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    const cv::Mat* frames[2] = { &scene.gray, &shifted };
+    
+    PipelineWorkspace workspace;
+    QRCornerTracker tracker;
+    RobustCalibrationData calibration;
+    if (!tracker.update(workspace, scene.gray, kBenchmarkQRSizeCm, calibration)) {
+        state.SkipWithError("QR non détecté sur la scène synthétique");
+        return;
+    }
+    size_t frame = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tracker.update(workspace, *frames[++frame % 2], kBenchmarkQRSizeCm, calibration));
+    }
+    setSceneCounters(state, scene);
+    state.counters["calibrated"] = calibration.is_calibrated ? 1 : 0;
+}
+
+void BM_GetExtremePoints(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    if (scene.contours.empty()) {
+        state.SkipWithError("Pied non segmenté sur la scène synthétique");
+        return;
+    }
+    const std::vector<cv::Point>& contour = scene.contours[scene.foot_idx];
+    for (auto _ : state) {
+        ExtremePoints points = getExtremePoints(contour);
+        benchmark::DoNotOptimize(points.bottom.y);
+    }
+    setSceneCounters(state, scene);
+    state.counters["contour_points"] = static_cast<double>(contour.size());
+}
+
+void BM_SubpixelExtremePoints(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    if (scene.contours.empty()) {
+        state.SkipWithError("Pied non segmenté sur la scène synthétique");
+        return;
+    }
+    PipelineWorkspace workspace;
+    FootProfile profile;
+    FootAxis axis = analyzeFootAxis(scene.contours[scene.foot_idx], profile);
+    ExtremePoints extremes = getAxisExtremePoints(scene.contours[scene.foot_idx], axis);
+    for (auto _ : state) {
+        SubpixelExtremePoints points = subpixelExtremePoints(workspace, scene.gray, extremes, axis);
+        benchmark::DoNotOptimize(points.bottom.y);
+    }
+    setSceneCounters(state, scene);
+}
+
+void BM_AnalyzeFootShapeAdaptive(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    if (scene.contours.empty()) {
+        state.SkipWithError("Pied non segmenté sur la scène synthétique");
+        return;
+    }
+    const std::vector<cv::Point>& contour = scene.contours[scene.foot_idx];
+    for (auto _ : state) {
+        FootMeasurements measurements = analyzeFootShapeAdaptive(contour, scene.calibration, scene.gray.size());
+        benchmark::DoNotOptimize(measurements.length_cm);
+    }
+    setSceneCounters(state, scene);
+}
+
+void BM_FilterFootComponents(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    PipelineWorkspace workspace;
+    workspace.component_stats = scene.component_stats;
+    workspace.component_centroids = scene.component_centroids;
+    const AdaptiveParams& params = workspace.adaptiveParams(scene.gray.size());
+    int best_label = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filterFootComponents(workspace, scene.gray.size(), params, best_label));
+    }
+    setSceneCounters(state, scene);
+    state.counters["regions"] = static_cast<double>(std::max(0, scene.component_stats.rows - 1));
+}
+
+void BM_SegmentFootAdaptive(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    PipelineWorkspace workspace;
+    const AdaptiveParams& params = workspace.adaptiveParams(scene.gray.size());
+    size_t best_contour_idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(segmentFootAdaptive(workspace, scene.gray, params, best_contour_idx));
+    }
+    setSceneCounters(state, scene);
+}
+
+void BM_RemoveBackground(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        int size = 0;
+        uint8_t* png = removeBackground(scene.path.c_str(), &size);
+        benchmark::DoNotOptimize(png);
+        freeMemory(png);
+    }
+    setSceneCounters(state, scene);
+}
+
+void BM_MeasureFootWithQR(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        int size = 0;
+        uint8_t* png = measureFootWithQR(scene.path.c_str(), &size, kBenchmarkQRSizeCm);
+        benchmark::DoNotOptimize(png);
+        freeMemory(png);
+    }
+    setSceneCounters(state, scene);
+}
+
+// Mesures seules sur une capture jamais vue: un décodage pleine résolution en niveaux de gris,
+// réduit pour la segmentation et la recherche QR, sans couleur
+void BM_FootImageMeasure(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    std::vector<uchar> jpeg;
+    cv::imencode(".jpg", scene.bgr, jpeg, {cv::IMWRITE_JPEG_QUALITY, 95});
+    FootMeasurementResult result;
+    result.struct_size = sizeof(FootMeasurementResult);
+    for (auto _ : state) {
+        clearFootImageCache();
+        void* image = createFootImage(jpeg.data(), static_cast<int>(jpeg.size()));
+        benchmark::DoNotOptimize(footImageMeasure(image, kBenchmarkQRSizeCm, &result));
+        destroyFootImage(image);
+    }
+    clearFootImageCache();
+    setSceneCounters(state, scene);
+}
+
+// Relance d'une capture déjà analysée avec une autre taille de QR (cache d'images)
+void BM_FootImageRetryQRSize(benchmark::State& state) {
+    const SyntheticScene& scene = sceneFor(static_cast<int>(state.range(0)));
+    std::vector<uchar> jpeg;
+    cv::imencode(".jpg", scene.bgr, jpeg, {cv::IMWRITE_JPEG_QUALITY, 95});
+    FootMeasurementResult result;
+    result.struct_size = sizeof(FootMeasurementResult);
+    
+    void* warm = createFootImage(jpeg.data(), static_cast<int>(jpeg.size()));
+    footImageMeasure(warm, kBenchmarkQRSizeCm, &result);
+    destroyFootImage(warm);
+    
+    double qr_size_cm = kBenchmarkQRSizeCm;
+    for (auto _ : state) {
+        qr_size_cm = (qr_size_cm == kBenchmarkQRSizeCm) ? kBenchmarkQRSizeCm + 0.5 : kBenchmarkQRSizeCm;
+        void* image = createFootImage(jpeg.data(), static_cast<int>(jpeg.size()));
+        benchmark::DoNotOptimize(footImageMeasure(image, qr_size_cm, &result));
+        destroyFootImage(image);
+    }
+    clearFootImageCache();
+    setSceneCounters(state, scene);
+}
+
+// Tailles d'image en mégapixels (argument de chaque benchmark)
+void sceneSizes(benchmark::internal::Benchmark* benchmark) {
+    for (int megapixels : {1, 3, 12, 48}) benchmark->Arg(megapixels);
+    benchmark->ArgName("mp")->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK(BM_EstimateQRModules)->Apply(sceneSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DetectRobustQRCalibration)->Apply(sceneSizes);
+BENCHMARK(BM_QRCornerTracking)->Apply(sceneSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_GetExtremePoints)->Apply(sceneSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SubpixelExtremePoints)->Apply(sceneSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AnalyzeFootShapeAdaptive)->Apply(sceneSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FilterFootComponents)->Apply(sceneSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SegmentFootAdaptive)->Apply(sceneSizes);
+BENCHMARK(BM_RemoveBackground)->Apply(sceneSizes);
+BENCHMARK(BM_MeasureFootWithQR)->Apply(sceneSizes);
+BENCHMARK(BM_FootImageMeasure)->Apply(sceneSizes);
+BENCHMARK(BM_FootImageRetryQRSize)->Apply(sceneSizes);
+
+BENCHMARK_MAIN();
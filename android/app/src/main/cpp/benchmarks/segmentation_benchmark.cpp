@@ -0,0 +1,72 @@
+// Benchmark du prétraitement de segmentation: séquentiel vs bandes parallèles
+// Scènes synthétiques 12 MP et 48 MP, 1 à 8 threads OpenCV.
+// Construction: cmake -DNATIVE_OPENCV_BENCHMARKS=ON, puis sur l'appareil:
+//   adb push segmentation_benchmark /data/local/tmp && adb shell /data/local/tmp/segmentation_benchmark [itérations]
+// Build hôte: ./segmentation_benchmark [itérations]
+
+#include "../native_opencv.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+// Fond clair bruité, pied sombre (ellipse) et carré plein à la place du QR
+cv::Mat makeSyntheticScene(const cv::Size& size) {
+    cv::Mat scene(size, CV_8UC1, cv::Scalar(200));
+    cv::Point center(size.width / 2, size.height / 2);
+    cv::ellipse(scene, center, cv::Size(size.width / 8, size.height / 3), 0, 0, 360, cv::Scalar(70), -1);
+    int qr_side = size.width / 12;
+    cv::rectangle(scene, cv::Rect(size.width / 10, size.height / 10, qr_side, qr_side), cv::Scalar(20), -1);
+    
+    cv::Mat noise(size, CV_8UC1);
+    cv::randn(noise, cv::Scalar(0), cv::Scalar(12));
+    cv::add(scene, noise, scene);
+    return scene;
+}
+
+double medianMs(const std::function<void()>& run, int iterations) {
+    std::vector<double> samples;
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    const cv::Size sizes[] = {cv::Size(4000, 3000), cv::Size(8000, 6000)};
+    const int thread_counts[] = {1, 2, 4, 8};
+    
+    std::printf("%-10s %-8s %10s %8s %10s\n", "image", "threads", "ms", "gain", "identique");
+    for (const cv::Size& size : sizes) {
+        cv::Mat scene = makeSyntheticScene(size);
+        PipelineWorkspace workspace;
+        const AdaptiveParams& params = workspace.adaptiveParams(size);
+        char label[16];
+        std::snprintf(label, sizeof(label), "%.0f MP", size.area() / 1e6);
+        
+        // Référence: chaîne séquentielle d'origine, un seul thread
+        cv::setNumThreads(1);
+        double serial_ms = medianMs([&]() { preprocessFootMask(workspace, scene, params); }, iterations);
+        cv::Mat reference = workspace.img_thresh.clone();
+        std::printf("%-10s %-8s %10.1f %8s %10s\n", label, "série", serial_ms, "1.00x", "-");
+        
+        for (int threads : thread_counts) {
+            cv::setNumThreads(threads);
+            double tiled_ms = medianMs([&]() { preprocessFootMaskTiled(workspace, scene, params); }, iterations);
+            bool identical = cv::countNonZero(workspace.img_thresh != reference) == 0;
+            std::printf("%-10s %-8d %10.1f %7.2fx %10s\n", label, threads, tiled_ms,
+                        serial_ms / tiled_ms, identical ? "oui" : "NON");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#ifndef NATIVE_LOG_H
+#define NATIVE_LOG_H
+
+// Journalisation native: logcat sur Android, stderr sur les autres plateformes
+// (build hôte Linux, outil footmeasure, benchmarks).
+//
+// Niveaux (priorités Android): LOGD < LOGI < LOGW < LOGE.
+// NATIVE_LOG_LEVEL fixe à la compilation le niveau minimal compilé: les niveaux
+// inférieurs ne génèrent aucun code (arguments ni évalués ni formatés).
+// Défaut: ERROR en release (NDEBUG), DEBUG sinon. Surcharge: -DNATIVE_LOG_LEVEL=4.
+// Les niveaux compilés sont ensuite filtrés à l'exécution (setNativeLogLevel).
+
+#ifndef LOG_TAG
+#define LOG_TAG "NativeOpenCV"
+#endif
+
+#define NATIVE_LOG_LEVEL_DEBUG 3
+#define NATIVE_LOG_LEVEL_INFO 4
+#define NATIVE_LOG_LEVEL_WARN 5
+#define NATIVE_LOG_LEVEL_ERROR 6
+#define NATIVE_LOG_LEVEL_SILENT 8
+
+#ifndef NATIVE_LOG_LEVEL
+#ifdef NDEBUG
+#define NATIVE_LOG_LEVEL NATIVE_LOG_LEVEL_ERROR
+#else
+#define NATIVE_LOG_LEVEL NATIVE_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#include <atomic>
+
+// Niveau minimal à l'exécution. inline sans static: une seule instance pour toutes les
+// unités de compilation d'un même binaire (règle de la définition unique)
+inline std::atomic<int>& nativeLogRuntimeLevel() {
+    static std::atomic<int> level(NATIVE_LOG_LEVEL);
+    return level;
+}
+
+static inline bool nativeLogEnabled(int level) {
+    return level >= nativeLogRuntimeLevel().load(std::memory_order_relaxed);
+}
+
+// Niveau désactivé à la compilation: format vérifié, code éliminé
+__attribute__((format(printf, 1, 2)))
+static inline void nativeLogDiscard(const char*, ...) {}
+
+#define NATIVE_LOG_DISCARD(...) do { if (false) nativeLogDiscard(__VA_ARGS__); } while (0)
+
+#ifdef __ANDROID__
+
+#include <android/log.h>
+
+#define NATIVE_LOG_WRITE(level, tag_char, ...) \
+    do { if (nativeLogEnabled(level)) __android_log_print(level, LOG_TAG, __VA_ARGS__); } while (0)
+
+#else
+
+#include <cstdarg>
+#include <cstdio>
+
+__attribute__((format(printf, 2, 3)))
+static inline void nativeLogPrint(char level, const char* format, ...) {
+    char line[1024];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    // Une seule écriture par ligne: pas d'entrelacement entre threads workers
+    std::fprintf(stderr, "%c/%s: %s\n", level, LOG_TAG, line);
+}
+
+#define NATIVE_LOG_WRITE(level, tag_char, ...) \
+    do { if (nativeLogEnabled(level)) nativeLogPrint(tag_char, __VA_ARGS__); } while (0)
+
+#endif
+
+#if NATIVE_LOG_LEVEL <= NATIVE_LOG_LEVEL_DEBUG
+#define LOGD(...) NATIVE_LOG_WRITE(NATIVE_LOG_LEVEL_DEBUG, 'D', __VA_ARGS__)
+#else
+#define LOGD(...) NATIVE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if NATIVE_LOG_LEVEL <= NATIVE_LOG_LEVEL_INFO
+#define LOGI(...) NATIVE_LOG_WRITE(NATIVE_LOG_LEVEL_INFO, 'I', __VA_ARGS__)
+#else
+#define LOGI(...) NATIVE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if NATIVE_LOG_LEVEL <= NATIVE_LOG_LEVEL_WARN
+#define LOGW(...) NATIVE_LOG_WRITE(NATIVE_LOG_LEVEL_WARN, 'W', __VA_ARGS__)
+#else
+#define LOGW(...) NATIVE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if NATIVE_LOG_LEVEL <= NATIVE_LOG_LEVEL_ERROR
+#define LOGE(...) NATIVE_LOG_WRITE(NATIVE_LOG_LEVEL_ERROR, 'E', __VA_ARGS__)
+#else
+#define LOGE(...) NATIVE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#endif // NATIVE_LOG_H
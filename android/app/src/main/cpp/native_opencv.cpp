@@ -3,11 +3,22 @@
 #include <cstring>
 #include <vector>
 #include <algorithm>
-#include <android/log.h>
+#include <memory>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cfloat>
+#include <cmath>
 
-#define LOG_TAG "NativeOpenCV"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#include "native_log.h"
+#include "native_opencv.h"
 
 extern "C" {
 
@@ -19,6 +30,28 @@ struct ExtremePoints {
     cv::Point right;
 };
 
+// Axe principal du pied (ACP des moments du contour)
+struct FootAxis {
+    cv::Point2f center;
+    cv::Point2f along;    // unitaire, orteils -> talon
+    cv::Point2f across;   // unitaire, along tourné de -90° (gauche -> droite pour un pied orteils en haut)
+};
+
+// Profil de largeur le long de l'axe, en fractions de la longueur du pied
+struct FootProfile {
+    bool valid;
+    double heel_to_arch;   // talon -> ligne des métatarses (largeur maximale de l'avant-pied), type Brannock
+    double big_toe;        // pointe -> base des orteils (largeur atteignant kToeWebWidthRatio de la précédente)
+};
+
+// Points extrêmes localisés au sous-pixel (bord d'intensité de l'image)
+struct SubpixelExtremePoints {
+    cv::Point2f top;
+    cv::Point2f bottom;
+    cv::Point2f left;
+    cv::Point2f right;
+};
+
 // Structure robuste pour les données de calibration QR
 struct RobustCalibrationData {
     double pixels_per_cm;
@@ -29,6 +62,16 @@ struct RobustCalibrationData {
     int qr_modules;
     double perspective_ratio;
     std::string qr_content;
+    std::vector<cv::Point2f> qr_quad;   // coins détectés (image analysée), vide sans QR
+};
+
+// QR détecté et décodé, indépendamment de sa taille réelle (calibration à part)
+struct QRDetection {
+    bool found = false;
+    std::string content;
+    std::vector<cv::Point2f> quad;
+    int modules = 0;
+    cv::Size2d straight_size;             // QR redressé, vide si indisponible (réel: mis à l'échelle par le suivi)
 };
 
 // Structure pour les mesures détaillées du pied
@@ -62,12 +105,188 @@ struct AdaptiveParams {
         
         border_width = std::min(image_size.width, image_size.height) / 15;
         
-        LOGI("📐 Paramètres adaptatifs: K=%dx%d, Aire=%.3f%%-%.1f%%, Border=%d", 
+        LOGD("📐 Paramètres adaptatifs: K=%dx%d, Aire=%.3f%%-%.1f%%, Border=%d", 
              kernel_size.width, kernel_size.height, 
              min_contour_area_ratio*100, max_contour_area_ratio*100, border_width);
     }
 };
 
+// Tampons réutilisables d'un appel à l'autre (session, suivi en direct)
+// Les cv::Mat gardent leur allocation tant que la taille et le type ne changent pas.
+// Restent alloués à chaque appel (petits objets): contours de findContours, contenu et
+// quadrilatère du QR, paramètres de la segmentation grossière, copie de l'image encodée.
+struct PipelineWorkspace {
+    cv::Mat img_bgr;
+    cv::Mat img_gray;
+    cv::Mat img_blurred;
+    cv::Mat img_thresh;
+    cv::Mat result;
+    cv::QRCodeDetector qr_detector;
+    std::vector<cv::Point2f> qr_points;
+    cv::Mat straight_qrcode;
+    cv::Mat qr_coarse;
+    std::vector<cv::Point2f> qr_coarse_points;
+    std::vector<std::vector<cv::Point>> contours;
+    cv::Mat component_labels;
+    cv::Mat component_stats;
+    cv::Mat component_centroids;
+    cv::Mat component_mask;
+    std::vector<std::pair<double, int>> candidate_regions;
+    std::vector<uchar> encode_buffer;
+    std::vector<cv::Point> overlay_contour;
+    
+    // Segmentation grossière: image réduite, seuil et polarité du dernier masque, fenêtres d'affinage
+    cv::Mat img_coarse;
+    double mask_threshold = 0.0;
+    bool mask_inverted = false;
+    cv::Mat refine_blurred;
+    cv::Mat refine_mask;
+    cv::Mat edge_strip;
+    cv::Mat edge_profile;
+    
+    // Chronométrage de l'appel en cours (voir CallTimer / StageTimer)
+    double stage_ms[FOOT_STAGE_COUNT] = {};
+    std::chrono::steady_clock::time_point call_start;
+    
+    // Préallocation pour une résolution connue (caméra)
+    void reserve(const cv::Size& size) {
+        img_bgr.create(size, CV_8UC3);
+        img_gray.create(size, CV_8UC1);
+        img_blurred.create(size, CV_8UC1);
+        img_thresh.create(size, CV_8UC1);
+        result.create(size, CV_8UC3);
+        const AdaptiveParams& params = adaptiveParams(size);
+        borderMask(size, params.border_width);
+        structuringElement(params.kernel_size);
+    }
+    
+    // Paramètres adaptatifs recalculés seulement si la taille change
+    const AdaptiveParams& adaptiveParams(const cv::Size& size) {
+        if (!params_ || params_size_ != size) {
+            params_.reset(new AdaptiveParams(size));
+            params_size_ = size;
+        }
+        return *params_;
+    }
+    
+    // Élément structurant mis en cache par taille de noyau
+    const cv::Mat& structuringElement(const cv::Size& size) {
+        if (kernel_.empty() || kernel_size_ != size) {
+            kernel_ = cv::getStructuringElement(cv::MORPH_ELLIPSE, size);
+            kernel_size_ = size;
+        }
+        return kernel_;
+    }
+    
+    // Masque des bords de l'image, reconstruit seulement si la géométrie change
+    const cv::Mat& borderMask(const cv::Size& size, int width) {
+        if (border_mask_.size() != size || border_mask_width_ != width) {
+            border_mask_.create(size, CV_8UC1);
+            border_mask_.setTo(cv::Scalar(0));
+            cv::rectangle(border_mask_, cv::Point(0, 0), 
+                         cv::Point(size.width, width), cv::Scalar(255), -1);
+            cv::rectangle(border_mask_, cv::Point(0, size.height - width), 
+                         cv::Point(size.width, size.height), cv::Scalar(255), -1);
+            cv::rectangle(border_mask_, cv::Point(0, 0), 
+                         cv::Point(width, size.height), cv::Scalar(255), -1);
+            cv::rectangle(border_mask_, cv::Point(size.width - width, 0), 
+                         cv::Point(size.width, size.height), cv::Scalar(255), -1);
+            border_mask_width_ = width;
+        }
+        return border_mask_;
+    }
+    
+private:
+    std::unique_ptr<AdaptiveParams> params_;
+    cv::Size params_size_;
+    cv::Mat kernel_;
+    cv::Size kernel_size_;
+    cv::Mat border_mask_;
+    int border_mask_width_ = -1;
+};
+
+// ============================================================================
+// CHRONOMÉTRAGE DES ÉTAPES: durées par appel (FootMeasurementResult.stage_ms)
+// et histogramme cumulé du processus (getTimingHistogram)
+// ============================================================================
+
+// Compteurs en µs; atomiques pour les workers de la file et des lots
+struct TimingHistogram {
+    std::atomic<uint64_t> count[FOOT_STAGE_COUNT];
+    std::atomic<uint64_t> total_us[FOOT_STAGE_COUNT];
+    std::atomic<uint64_t> max_us[FOOT_STAGE_COUNT];
+    std::atomic<uint64_t> buckets[FOOT_STAGE_COUNT][FOOT_TIMING_BUCKETS];
+};
+
+static TimingHistogram g_timing_histogram;
+
+void recordStageTiming(int stage, double ms) {
+    uint64_t us = static_cast<uint64_t>(std::max(0.0, ms) * 1000.0);
+    int bucket = 0;
+    while (bucket < FOOT_TIMING_BUCKETS - 1 && (us >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    
+    TimingHistogram& histogram = g_timing_histogram;
+    histogram.count[stage].fetch_add(1, std::memory_order_relaxed);
+    histogram.total_us[stage].fetch_add(us, std::memory_order_relaxed);
+    histogram.buckets[stage][bucket].fetch_add(1, std::memory_order_relaxed);
+    uint64_t previous_max = histogram.max_us[stage].load(std::memory_order_relaxed);
+    while (us > previous_max &&
+           !histogram.max_us[stage].compare_exchange_weak(previous_max, us, std::memory_order_relaxed)) {
+    }
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Chronomètre d'une étape: durée ajoutée au workspace en fin de portée (une étape peut
+// couvrir plusieurs portées d'un même appel; l'histogramme reçoit leur somme via CallTimer)
+class StageTimer {
+public:
+    StageTimer(PipelineWorkspace& workspace, FootPipelineStage stage)
+        : workspace_(workspace), stage_(stage), start_(std::chrono::steady_clock::now()) {}
+    
+    ~StageTimer() {
+        workspace_.stage_ms[stage_] += elapsedMs(start_);
+    }
+    
+private:
+    PipelineWorkspace& workspace_;
+    FootPipelineStage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Chronomètre d'un appel complet: remet à zéro les durées du workspace, puis en fin de
+// portée enregistre dans l'histogramme une mesure par étape exécutée et le total, et copie
+// les durées dans result (si sa version les couvre)
+class CallTimer {
+public:
+    CallTimer(PipelineWorkspace& workspace, FootMeasurementResult* result)
+        : workspace_(workspace), result_(result) {
+        std::fill(workspace_.stage_ms, workspace_.stage_ms + FOOT_STAGE_COUNT, 0.0);
+        workspace_.call_start = std::chrono::steady_clock::now();
+    }
+    
+    ~CallTimer() {
+        double total_ms = elapsedMs(workspace_.call_start);
+        workspace_.stage_ms[FOOT_STAGE_TOTAL] = total_ms;
+        for (int stage = 0; stage < FOOT_STAGE_TOTAL; stage++) {
+            if (workspace_.stage_ms[stage] > 0.0) recordStageTiming(stage, workspace_.stage_ms[stage]);
+        }
+        recordStageTiming(FOOT_STAGE_TOTAL, total_ms);
+        
+        if (result_ != nullptr && result_->struct_size >= sizeof(FootMeasurementResult)) {
+            std::copy(workspace_.stage_ms, workspace_.stage_ms + FOOT_STAGE_COUNT, result_->stage_ms);
+        }
+    }
+    
+private:
+    PipelineWorkspace& workspace_;
+    FootMeasurementResult* result_;
+};
+
 // Fonction de test
 __attribute__((visibility("default")))
 int testFunction() {
@@ -116,87 +335,188 @@ int estimateQRModules(const cv::Mat& straight_qrcode) {
     }
 }
 
-// Détection QR robuste avec gestion perspective
-RobustCalibrationData detectRobustQRCalibration(const cv::Mat& image, double qr_real_size_cm) {
+// Recherche QR grossière: côté long de l'image réduite au moins égal à cette valeur
+const int kQRCoarseMinLongEdge = 800;
+// Marge autour du QR localisé, en fraction de sa taille
+const double kQRRoiMargin = 0.25;
+
+// Facteur de réduction de la recherche grossière (2, 4 ou 8; 1 = pleine résolution seule)
+int coarseReductionFactor(const cv::Size& size) {
+    int long_edge = std::max(size.width, size.height);
+    int factor = 8;
+    while (factor > 1 && long_edge / factor < kQRCoarseMinLongEdge) {
+        factor /= 2;
+    }
+    return factor;
+}
+
+// Localisation du QR sur l'image réduite (niveaux de gris), détection/décodage dans la ROI
+// correspondante de l'image pleine résolution. Chaîne vide si l'une des deux étapes échoue.
+std::string detectQRInReduced(PipelineWorkspace& workspace, const cv::Mat& reduced, const cv::Mat& image,
+                              std::vector<cv::Point2f>& points, cv::Mat& straight_qrcode) {
+    std::vector<cv::Point2f>& coarse_points = workspace.qr_coarse_points;
+    if (!workspace.qr_detector.detect(reduced, coarse_points) || coarse_points.size() != 4) {
+        return std::string();
+    }
+    
+    double sx = static_cast<double>(image.cols) / reduced.cols;
+    double sy = static_cast<double>(image.rows) / reduced.rows;
+    cv::Rect box = cv::boundingRect(coarse_points);
+    int margin = cvCeil(kQRRoiMargin * std::max(box.width, box.height)) + 1;
+    cv::Rect roi(cvFloor((box.x - margin) * sx), cvFloor((box.y - margin) * sy),
+                 cvCeil((box.width + 2 * margin) * sx), cvCeil((box.height + 2 * margin) * sy));
+    roi &= cv::Rect(0, 0, image.cols, image.rows);
+    if (roi.area() <= 0) return std::string();
+    
+    std::string decoded = workspace.qr_detector.detectAndDecode(image(roi), points, straight_qrcode);
+    if (decoded.empty() || points.size() != 4) return std::string();
+    for (auto& point : points) {
+        point.x += roi.x;
+        point.y += roi.y;
+    }
+    LOGD("🔎 QR localisé à 1/%.0f, ROI %dx%d", sx, roi.width, roi.height);
+    return decoded;
+}
+
+// Détection QR du grossier au fin: localisation sur une image réduite (1/2 à 1/8),
+// puis détection/décodage à pleine résolution dans la seule ROI du QR.
+// Les coins sont ceux de la pleine résolution: pixels_per_cm inchangé.
+// reduced: image réduite déjà disponible (nœud reduced de l'image analysée), vide = réduite ici.
+// Repli sur l'image entière si l'une des deux étapes échoue.
+std::string detectQRCoarseToFine(PipelineWorkspace& workspace, const cv::Mat& image, const cv::Mat& reduced,
+                                 std::vector<cv::Point2f>& points, cv::Mat& straight_qrcode) {
+    int factor = coarseReductionFactor(image.size());
+    if (factor > 1) {
+        const cv::Mat* coarse = &reduced;
+        if (reduced.empty()) {
+            cv::Mat& resized = workspace.qr_coarse;
+            cv::resize(image, resized, cv::Size(image.cols / factor, image.rows / factor), 0, 0, cv::INTER_AREA);
+            if (resized.channels() == 3) {
+                cv::cvtColor(resized, resized, cv::COLOR_BGR2GRAY);
+            }
+            coarse = &resized;
+        }
+        
+        std::string decoded = detectQRInReduced(workspace, *coarse, image, points, straight_qrcode);
+        if (!decoded.empty()) return decoded;
+        LOGD("🔎 QR non localisé à 1/%d, recherche pleine résolution", factor);
+    }
+    
+    return workspace.qr_detector.detectAndDecode(image, points, straight_qrcode);
+}
+
+// Détection et décodage du QR (détecteur et tampons du workspace)
+// reduced: image réduite de la recherche grossière si déjà disponible, sinon vide
+QRDetection detectQRCodeWith(PipelineWorkspace& workspace, const cv::Mat& image, const cv::Mat& reduced) {
+    StageTimer timer(workspace, FOOT_STAGE_QR);
+    QRDetection detection;
+    
+    try {
+        std::vector<cv::Point2f>& points = workspace.qr_points;
+        cv::Mat& straight_qrcode = workspace.straight_qrcode;
+        std::string decoded_info = detectQRCoarseToFine(workspace, image, reduced, points, straight_qrcode);
+        
+        if (decoded_info.empty() || points.size() != 4) {
+            LOGW("❌ QR non détecté");
+            return detection;
+        }
+        
+        detection.found = true;
+        detection.content = decoded_info;
+        detection.quad = points;
+        detection.modules = estimateQRModules(straight_qrcode);
+        cv::Size straight_size = straight_qrcode.size();
+        detection.straight_size = cv::Size2d(straight_size.width, straight_size.height);
+        LOGD("🎯 QR détecté: %s", decoded_info.substr(0, 50).c_str());
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception QR: %s", e.what());
+    }
+    
+    return detection;
+}
+
+// Calibration robuste avec gestion perspective à partir d'un QR détecté
+RobustCalibrationData calibrateFromQR(const QRDetection& detection, double qr_real_size_cm) {
     RobustCalibrationData calibration;
     calibration.is_calibrated = false;
     calibration.pixels_per_cm = 0.0;
     calibration.qr_modules = 0;
     calibration.perspective_ratio = 1.0;
+    calibration.qr_size_pixels_raw = 0.0;
+    calibration.qr_size_pixels_corrected = 0.0;
     
-    try {
-        cv::QRCodeDetector qr_detector;
-        std::vector<cv::Point2f> points;
-        cv::Mat straight_qrcode;
-        std::string decoded_info;
-        
-        decoded_info = qr_detector.detectAndDecode(image, points, straight_qrcode);
-        
-        if (decoded_info.empty() || points.size() != 4) {
-            LOGI("❌ QR non détecté");
-            return calibration;
-        }
+    if (!detection.found) {
+        return calibration;
+    }
+    
+    const std::vector<cv::Point2f>& points = detection.quad;
+    calibration.qr_content = detection.content;
+    calibration.qr_quad = points;
+    
+    // Validation modules
+    calibration.qr_modules = detection.modules;
+    if (calibration.qr_modules < 21 || calibration.qr_modules > 177) {
+        LOGE("❌ Modules QR invalides: %d", calibration.qr_modules);
+        return calibration;
+    }
+    LOGD("✅ Modules validés: %d", calibration.qr_modules);
+    
+    // Centre géométrique
+    calibration.qr_center = cv::Point2f(0, 0);
+    for (const auto& point : points) {
+        calibration.qr_center += point;
+    }
+    calibration.qr_center /= 4.0f;
+    
+    // Taille brute dans l'image
+    double side1 = cv::norm(points[0] - points[1]);
+    double side2 = cv::norm(points[1] - points[2]);
+    double side3 = cv::norm(points[2] - points[3]);
+    double side4 = cv::norm(points[3] - points[0]);
+    calibration.qr_size_pixels_raw = (side1 + side2 + side3 + side4) / 4.0;
+    
+    // Gestion perspective avec straight_qrcode
+    if (detection.straight_size.area() > 0) {
+        double corrected_size = std::min(detection.straight_size.height, detection.straight_size.width);
+        calibration.qr_size_pixels_corrected = corrected_size;
+        calibration.perspective_ratio = calibration.qr_size_pixels_corrected / calibration.qr_size_pixels_raw;
         
-        calibration.qr_content = decoded_info;
-        LOGI("🎯 QR détecté: %s", decoded_info.substr(0, 50).c_str());
+        LOGD("📐 Perspective: brute=%.2f, corrigée=%.2f, ratio=%.3f", 
+             calibration.qr_size_pixels_raw, calibration.qr_size_pixels_corrected, calibration.perspective_ratio);
         
-        // Validation modules
-        calibration.qr_modules = estimateQRModules(straight_qrcode);
-        if (calibration.qr_modules < 21 || calibration.qr_modules > 177) {
-            LOGE("❌ Modules QR invalides: %d", calibration.qr_modules);
+        if (calibration.perspective_ratio < 0.5 || calibration.perspective_ratio > 2.0) {
+            LOGE("❌ Déformation excessive: %.3f", calibration.perspective_ratio);
             return calibration;
         }
-        LOGI("✅ Modules validés: %d", calibration.qr_modules);
-        
-        // Centre géométrique
-        calibration.qr_center = cv::Point2f(0, 0);
-        for (const auto& point : points) {
-            calibration.qr_center += point;
-        }
-        calibration.qr_center /= 4.0f;
-        
-        // Taille brute dans l'image
-        double side1 = cv::norm(points[0] - points[1]);
-        double side2 = cv::norm(points[1] - points[2]);
-        double side3 = cv::norm(points[2] - points[3]);
-        double side4 = cv::norm(points[3] - points[0]);
-        calibration.qr_size_pixels_raw = (side1 + side2 + side3 + side4) / 4.0;
-        
-        // Gestion perspective avec straight_qrcode
-        if (!straight_qrcode.empty()) {
-            double corrected_size = std::min(straight_qrcode.rows, straight_qrcode.cols);
-            calibration.qr_size_pixels_corrected = corrected_size;
-            calibration.perspective_ratio = calibration.qr_size_pixels_corrected / calibration.qr_size_pixels_raw;
-            
-            LOGI("📐 Perspective: brute=%.2f, corrigée=%.2f, ratio=%.3f", 
-                 calibration.qr_size_pixels_raw, calibration.qr_size_pixels_corrected, calibration.perspective_ratio);
-            
-            if (calibration.perspective_ratio < 0.5 || calibration.perspective_ratio > 2.0) {
-                LOGE("❌ Déformation excessive: %.3f", calibration.perspective_ratio);
-                return calibration;
-            }
-            
-            calibration.pixels_per_cm = calibration.qr_size_pixels_corrected / qr_real_size_cm;
-        } else {
-            LOGI("⚠️ straight_qrcode vide");
-            calibration.qr_size_pixels_corrected = calibration.qr_size_pixels_raw;
-            calibration.pixels_per_cm = calibration.qr_size_pixels_raw / qr_real_size_cm;
-        }
-        
-        if (calibration.pixels_per_cm > 30.0 && calibration.pixels_per_cm < 800.0) {
-            calibration.is_calibrated = true;
-            LOGI("✅ CALIBRATION RÉUSSIE: %.3f pixels/cm", calibration.pixels_per_cm);
-        } else {
-            LOGE("❌ Ratio invalide: %.2f", calibration.pixels_per_cm);
-        }
         
-    } catch (const std::exception& e) {
-        LOGE("❌ Exception QR: %s", e.what());
+        calibration.pixels_per_cm = calibration.qr_size_pixels_corrected / qr_real_size_cm;
+    } else {
+        LOGW("⚠️ straight_qrcode vide");
+        calibration.qr_size_pixels_corrected = calibration.qr_size_pixels_raw;
+        calibration.pixels_per_cm = calibration.qr_size_pixels_raw / qr_real_size_cm;
+    }
+    
+    if (calibration.pixels_per_cm > 30.0 && calibration.pixels_per_cm < 800.0) {
+        calibration.is_calibrated = true;
+        LOGI("✅ CALIBRATION RÉUSSIE: %.3f pixels/cm", calibration.pixels_per_cm);
+    } else {
+        LOGE("❌ Ratio invalide: %.2f", calibration.pixels_per_cm);
     }
     
     return calibration;
 }
 
+// Détection QR robuste avec gestion perspective (détecteur et tampons du workspace)
+RobustCalibrationData detectRobustQRCalibrationWith(PipelineWorkspace& workspace, const cv::Mat& image, double qr_real_size_cm) {
+    return calibrateFromQR(detectQRCodeWith(workspace, image, cv::Mat()), qr_real_size_cm);
+}
+
+// Détection QR ponctuelle
+RobustCalibrationData detectRobustQRCalibration(const cv::Mat& image, double qr_real_size_cm) {
+    PipelineWorkspace workspace;
+    return detectRobustQRCalibrationWith(workspace, image, qr_real_size_cm);
+}
+
 // Points extrêmes d'un contour
 ExtremePoints getExtremePoints(const std::vector<cv::Point>& contour) {
     ExtremePoints extremes;
@@ -214,41 +534,148 @@ ExtremePoints getExtremePoints(const std::vector<cv::Point>& contour) {
     return extremes;
 }
 
-// Analyse adaptative du pied
-FootMeasurements analyzeFootShapeAdaptive(const std::vector<cv::Point>& foot_contour, 
-                                          const RobustCalibrationData& calibration,
-                                          const cv::Size& image_size) {
-    FootMeasurements measurements;
-    measurements.is_calibrated = calibration.is_calibrated;
+// Proportions par défaut (profil inexploitable)
+const double kDefaultHeelToArchRatio = 0.60;
+const double kDefaultBigToeRatio = 0.15;
+// Tranches du profil de largeur le long de l'axe
+const int kFootProfileBins = 128;
+// Base des orteils: première tranche (depuis la pointe) dont la largeur atteint cette part de celle des métatarses
+const double kToeWebWidthRatio = 0.85;
+
+// Axe principal (ACP: moments centrés d'ordre 2 du contour) et profil de largeur le long de l'axe.
+// L'axe est orienté orteils -> talon: vers le bas de l'image par défaut, retourné quand le profil
+// montre l'avant-pied (plus large que le talon) du côté bas.
+FootAxis analyzeFootAxis(const std::vector<cv::Point>& contour, FootProfile& profile) {
+    FootAxis axis;
+    axis.along = cv::Point2f(0.0f, 1.0f);
+    profile.valid = false;
+    profile.heel_to_arch = kDefaultHeelToArchRatio;
+    profile.big_toe = kDefaultBigToeRatio;
     
-    if (foot_contour.empty()) {
-        LOGE("Contour vide");
-        measurements.length_cm = 0.0;
-        measurements.width_cm = 0.0;
-        measurements.heel_to_arch_cm = 0.0;
-        measurements.arch_to_toe_cm = 0.0;
-        measurements.big_toe_length_cm = 0.0;
-        return measurements;
+    cv::Moments moments = cv::moments(contour);
+    if (moments.m00 > 0) {
+        axis.center = cv::Point2f(static_cast<float>(moments.m10 / moments.m00),
+                                  static_cast<float>(moments.m01 / moments.m00));
+        double angle = 0.5 * std::atan2(2.0 * moments.mu11, moments.mu20 - moments.mu02);
+        axis.along = cv::Point2f(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+        if (axis.along.y < 0 || (axis.along.y == 0 && axis.along.x < 0)) axis.along = -axis.along;
+    } else if (!contour.empty()) {
+        cv::Rect bbox = cv::boundingRect(contour);
+        axis.center = cv::Point2f(bbox.x + bbox.width * 0.5f, bbox.y + bbox.height * 0.5f);
+    }
+    axis.across = cv::Point2f(axis.along.y, -axis.along.x);
+    if (contour.size() < 3) return axis;
+    
+    // Étendue le long de l'axe (atteinte sur des sommets du polygone)
+    float s_min = FLT_MAX, s_max = -FLT_MAX;
+    for (const auto& point : contour) {
+        float s = (point.x - axis.center.x) * axis.along.x + (point.y - axis.center.y) * axis.along.y;
+        s_min = std::min(s_min, s);
+        s_max = std::max(s_max, s);
+    }
+    float extent = s_max - s_min;
+    if (extent <= 0) return axis;
+    
+    // Largeur par tranche: arêtes du contour rééchantillonnées au pas d'une tranche
+    // (CHAIN_APPROX_SIMPLE ne garde que les sommets)
+    float t_min[kFootProfileBins], t_max[kFootProfileBins];
+    std::fill(t_min, t_min + kFootProfileBins, FLT_MAX);
+    std::fill(t_max, t_max + kFootProfileBins, -FLT_MAX);
+    const float bin_scale = kFootProfileBins / extent;
+    for (size_t i = 0; i < contour.size(); i++) {
+        cv::Point2f a = cv::Point2f(contour[i]) - axis.center;
+        cv::Point2f b = cv::Point2f(contour[(i + 1) % contour.size()]) - axis.center;
+        float sa = a.dot(axis.along), ta = a.dot(axis.across);
+        float sb = b.dot(axis.along), tb = b.dot(axis.across);
+        int steps = 1 + static_cast<int>(std::abs(sb - sa) * bin_scale);
+        for (int k = 0; k <= steps; k++) {
+            float f = static_cast<float>(k) / steps;
+            float s = sa + (sb - sa) * f;
+            float t = ta + (tb - ta) * f;
+            int bin = std::min(kFootProfileBins - 1, std::max(0, static_cast<int>((s - s_min) * bin_scale)));
+            t_min[bin] = std::min(t_min[bin], t);
+            t_max[bin] = std::max(t_max[bin], t);
+        }
+    }
+    
+    // Largeurs lissées sur 3 tranches (orteils et bruit du contour)
+    float raw[kFootProfileBins], width[kFootProfileBins];
+    for (int b = 0; b < kFootProfileBins; b++) {
+        raw[b] = t_max[b] >= t_min[b] ? t_max[b] - t_min[b] : 0.0f;
     }
+    for (int b = 0; b < kFootProfileBins; b++) {
+        int lo = std::max(0, b - 1), hi = std::min(kFootProfileBins - 1, b + 1);
+        float sum = 0.0f;
+        for (int k = lo; k <= hi; k++) sum += raw[k];
+        width[b] = sum / (hi - lo + 1);
+    }
+    
+    // Orientation: l'avant-pied est plus large que le talon
+    const int front_end = kFootProfileBins * 2 / 5;
+    const int back_start = kFootProfileBins * 3 / 5;
+    float front_max = *std::max_element(width, width + front_end);
+    float back_max = *std::max_element(width + back_start, width + kFootProfileBins);
+    if (back_max > front_max * 1.1f) {
+        axis.along = -axis.along;
+        axis.across = -axis.across;
+        std::reverse(width, width + kFootProfileBins);
+    }
+    
+    // Ligne des métatarses: largeur maximale de la moitié avant (pointe exclue)
+    const int half = kFootProfileBins / 2;
+    int ball = static_cast<int>(std::max_element(width, width + half) - width);
+    if (ball < 2 || width[ball] <= 0.0f) return axis;
+    int web = 0;
+    while (web < ball && width[web] < width[ball] * kToeWebWidthRatio) web++;
+    if (web == 0) return axis;
     
-    // Points extrêmes
-    measurements.heel_point = foot_contour[0];
-    measurements.toe_point = foot_contour[0];
-    measurements.left_point = foot_contour[0];
-    measurements.right_point = foot_contour[0];
+    profile.valid = true;
+    profile.heel_to_arch = 1.0 - (ball + 0.5) / kFootProfileBins;
+    profile.big_toe = (web + 0.5) / kFootProfileBins;
+    LOGD("🦶 Profil: talon->creux %.2f, orteil %.2f (axe %.1f°)", profile.heel_to_arch, profile.big_toe,
+         std::atan2(axis.along.x, axis.along.y) * 180.0 / CV_PI);
+    return axis;
+}
+
+// Points extrêmes dans le repère de l'axe: top = orteils, bottom = talon, left/right en travers
+ExtremePoints getAxisExtremePoints(const std::vector<cv::Point>& contour, const FootAxis& axis) {
+    ExtremePoints extremes;
+    if (contour.empty()) return extremes;
     
-    for (const auto& point : foot_contour) {
-        if (point.y > measurements.heel_point.y) measurements.heel_point = point;
-        if (point.y < measurements.toe_point.y) measurements.toe_point = point;
-        if (point.x < measurements.left_point.x) measurements.left_point = point;
-        if (point.x > measurements.right_point.x) measurements.right_point = point;
+    extremes.left = extremes.right = extremes.top = extremes.bottom = contour[0];
+    float s_min = FLT_MAX, s_max = -FLT_MAX, t_min = FLT_MAX, t_max = -FLT_MAX;
+    for (const auto& point : contour) {
+        float s = point.x * axis.along.x + point.y * axis.along.y;
+        float t = point.x * axis.across.x + point.y * axis.across.y;
+        if (s < s_min) { s_min = s; extremes.top = point; }
+        if (s > s_max) { s_max = s; extremes.bottom = point; }
+        if (t < t_min) { t_min = t; extremes.left = point; }
+        if (t > t_max) { t_max = t; extremes.right = point; }
     }
     
+    return extremes;
+}
+
+// Mesures à partir des points extrêmes du pied: longueur le long de l'axe, largeur en travers,
+// talon -> métatarses et orteil selon le profil de largeur
+FootMeasurements analyzeFootExtremes(const SubpixelExtremePoints& extremes,
+                                     const FootAxis& axis,
+                                     const FootProfile& profile,
+                                     const RobustCalibrationData& calibration,
+                                     const cv::Size& image_size) {
+    FootMeasurements measurements;
+    measurements.is_calibrated = calibration.is_calibrated;
+    
+    measurements.heel_point = extremes.bottom;
+    measurements.toe_point = extremes.top;
+    measurements.left_point = extremes.left;
+    measurements.right_point = extremes.right;
+    
     // Distances en pixels
-    double length_pixels = cv::norm(measurements.heel_point - measurements.toe_point);
-    double width_pixels = cv::norm(measurements.left_point - measurements.right_point);
+    double length_pixels = std::abs((measurements.heel_point - measurements.toe_point).dot(axis.along));
+    double width_pixels = std::abs((measurements.right_point - measurements.left_point).dot(axis.across));
     
-    LOGI("📏 Pixels: L=%.2f, W=%.2f", length_pixels, width_pixels);
+    LOGD("📏 Pixels: L=%.2f, W=%.2f", length_pixels, width_pixels);
     
     // Conversion en centimètres
     if (calibration.is_calibrated && calibration.pixels_per_cm > 0) {
@@ -260,17 +687,17 @@ FootMeasurements analyzeFootShapeAdaptive(const std::vector<cv::Point>& foot_con
                                    std::max(image_size.width, image_size.height);
             if (distance_factor > 0.3) {
                 effective_ratio *= (1.0 + (distance_factor - 0.3) * 0.1);
-                LOGI("🔧 Correction distance: %.3f", effective_ratio);
+                LOGD("🔧 Correction distance: %.3f", effective_ratio);
             }
         }
         
         measurements.length_cm = length_pixels / effective_ratio;
         measurements.width_cm = width_pixels / effective_ratio;
-        measurements.heel_to_arch_cm = measurements.length_cm * 0.60;
-        measurements.arch_to_toe_cm = measurements.length_cm * 0.40;
-        measurements.big_toe_length_cm = measurements.length_cm * 0.15;
+        measurements.heel_to_arch_cm = measurements.length_cm * profile.heel_to_arch;
+        measurements.arch_to_toe_cm = measurements.length_cm - measurements.heel_to_arch_cm;
+        measurements.big_toe_length_cm = measurements.length_cm * profile.big_toe;
         
-        LOGI("✅ CALIBRÉ QR: %.3f pixels/cm", effective_ratio);
+        LOGD("✅ CALIBRÉ QR: %.3f pixels/cm", effective_ratio);
         
     } else {
         // Estimation adaptative
@@ -287,249 +714,781 @@ FootMeasurements analyzeFootShapeAdaptive(const std::vector<cv::Point>& foot_con
         
         measurements.length_cm = length_pixels / estimated_pixels_per_cm;
         measurements.width_cm = width_pixels / estimated_pixels_per_cm;
-        measurements.heel_to_arch_cm = measurements.length_cm * 0.60;
-        measurements.arch_to_toe_cm = measurements.length_cm * 0.40;
-        measurements.big_toe_length_cm = measurements.length_cm * 0.15;
+        measurements.heel_to_arch_cm = measurements.length_cm * profile.heel_to_arch;
+        measurements.arch_to_toe_cm = measurements.length_cm - measurements.heel_to_arch_cm;
+        measurements.big_toe_length_cm = measurements.length_cm * profile.big_toe;
         
-        LOGI("⚠️ ESTIMATION: %.0f pixels/cm (%.1fMP)", estimated_pixels_per_cm, total_pixels/1000000.0);
+        LOGW("⚠️ ESTIMATION: %.0f pixels/cm (%.1fMP)", estimated_pixels_per_cm, total_pixels/1000000.0);
     }
     
-    LOGI("📏 FINAL: L=%.2fcm, W=%.2fcm", measurements.length_cm, measurements.width_cm);
+    LOGD("📏 FINAL: L=%.2fcm, W=%.2fcm", measurements.length_cm, measurements.width_cm);
     
     return measurements;
 }
 
-// FONCTION PRINCIPALE ROBUSTE
-__attribute__((visibility("default")))
-uint8_t* measureFootWithQR(const char* path, int* outSize, double qr_size_cm) {
-    LOGI("🔍 measureFootWithQR robuste (QR: %.1f cm)", qr_size_cm);
-    
-    if (path == nullptr || outSize == nullptr) {
-        LOGE("Paramètres invalides");
-        *outSize = 0;
-        return nullptr;
+// Analyse adaptative du pied
+FootMeasurements analyzeFootShapeAdaptive(const std::vector<cv::Point>& foot_contour, 
+                                          const RobustCalibrationData& calibration,
+                                          const cv::Size& image_size) {
+    if (foot_contour.empty()) {
+        LOGE("Contour vide");
+        FootMeasurements measurements;
+        measurements.is_calibrated = calibration.is_calibrated;
+        measurements.length_cm = 0.0;
+        measurements.width_cm = 0.0;
+        measurements.heel_to_arch_cm = 0.0;
+        measurements.arch_to_toe_cm = 0.0;
+        measurements.big_toe_length_cm = 0.0;
+        return measurements;
     }
     
-    try {
-        cv::Mat img_bgr = cv::imread(path, cv::IMREAD_COLOR);
-        if (img_bgr.empty()) {
-            LOGE("Image vide");
-            *outSize = 0;
-            return nullptr;
-        }
-        
-        LOGI("📸 Image: %dx%d (%.1fMP)", img_bgr.cols, img_bgr.rows, 
-             (img_bgr.cols * img_bgr.rows) / 1000000.0);
-        
-        // ÉTAPE 1: Calibration QR robuste
-        RobustCalibrationData calibration = detectRobustQRCalibration(img_bgr, qr_size_cm);
-        
-        // ÉTAPE 2: Paramètres adaptatifs
-        AdaptiveParams params(img_bgr.size());
-        
-        // ÉTAPE 3: Détection adaptative du pied
-        cv::Mat img_gray;
-        cv::cvtColor(img_bgr, img_gray, cv::COLOR_BGR2GRAY);
-        
-        cv::Mat img_blurred;
+    FootProfile profile;
+    FootAxis axis = analyzeFootAxis(foot_contour, profile);
+    ExtremePoints extremes = getAxisExtremePoints(foot_contour, axis);
+    SubpixelExtremePoints points = { extremes.top, extremes.bottom, extremes.left, extremes.right };
+    return analyzeFootExtremes(points, axis, profile, calibration, image_size);
+}
+
+// Masque du pied, version séquentielle: flou, Otsu, fermeture, ouverture (workspace.img_thresh)
+void preprocessFootMask(PipelineWorkspace& workspace, const cv::Mat& img_gray, const AdaptiveParams& params) {
+    cv::Mat& img_blurred = workspace.img_blurred;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_BLUR);
         cv::GaussianBlur(img_gray, img_blurred, cv::Size(5, 5), 0);
+    }
+    
+    cv::Mat& img_thresh = workspace.img_thresh;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_THRESHOLD);
         
         // Détection du fond
-        cv::Mat border_mask = cv::Mat::zeros(img_gray.size(), CV_8UC1);
-        cv::rectangle(border_mask, cv::Point(0, 0), 
-                     cv::Point(img_gray.cols, params.border_width), cv::Scalar(255), -1);
-        cv::rectangle(border_mask, cv::Point(0, img_gray.rows - params.border_width), 
-                     cv::Point(img_gray.cols, img_gray.rows), cv::Scalar(255), -1);
-        cv::rectangle(border_mask, cv::Point(0, 0), 
-                     cv::Point(params.border_width, img_gray.rows), cv::Scalar(255), -1);
-        cv::rectangle(border_mask, cv::Point(img_gray.cols - params.border_width, 0), 
-                     cv::Point(img_gray.cols, img_gray.rows), cv::Scalar(255), -1);
-        
+        const cv::Mat& border_mask = workspace.borderMask(img_gray.size(), params.border_width);
         cv::Scalar border_mean = cv::mean(img_blurred, border_mask);
         double background_intensity = border_mean[0];
         
-        cv::Mat img_thresh;
         double otsu_threshold = cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
         
-        if (background_intensity > 128 && otsu_threshold > background_intensity * 0.7) {
+        workspace.mask_threshold = otsu_threshold;
+        workspace.mask_inverted = background_intensity > 128 && otsu_threshold > background_intensity * 0.7;
+        if (workspace.mask_inverted) {
             cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
-            LOGI("Fond clair détecté");
+            LOGD("Fond clair détecté");
         } else {
-            LOGI("Fond sombre détecté");
-        }
-        
-        // Morphologie adaptative
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, params.kernel_size);
-        cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_CLOSE, kernel);
-        cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_OPEN, kernel);
-        
-        // Contours avec filtrage adaptatif
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(img_thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        
-        if (contours.empty()) {
-            LOGE("Aucun contour");
-            *outSize = 0;
-            return nullptr;
-        }
-        
-        // Filtrage adaptatif
-        std::vector<std::pair<double, size_t>> valid_contours;
-        double total_area = img_gray.rows * img_gray.cols;
-        double min_area = total_area * params.min_contour_area_ratio;
-        double max_area = total_area * params.max_contour_area_ratio;
-        
-        for (size_t i = 0; i < contours.size(); i++) {
-            double area = cv::contourArea(contours[i]);
-            if (area > min_area && area < max_area) {
-                cv::Rect bbox = cv::boundingRect(contours[i]);
-                bool near_border = (bbox.x < params.border_width || 
-                                   bbox.y < params.border_width ||
-                                   bbox.x + bbox.width > img_gray.cols - params.border_width ||
-                                   bbox.y + bbox.height > img_gray.rows - params.border_width);
-                
-                if (!near_border || area > total_area * 0.3) {
-                    valid_contours.push_back(std::make_pair(area, i));
-                }
-            }
+            LOGD("Fond sombre détecté");
         }
-        
-        std::sort(valid_contours.begin(), valid_contours.end(), 
-                  [](const auto& a, const auto& b) { return a.first > b.first; });
-        
-        if (valid_contours.empty()) {
-            LOGE("Aucun contour valide");
-            *outSize = 0;
-            return nullptr;
+    }
+    
+    // Morphologie adaptative
+    StageTimer timer(workspace, FOOT_STAGE_MORPHOLOGY);
+    const cv::Mat& kernel = workspace.structuringElement(params.kernel_size);
+    cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_OPEN, kernel);
+}
+
+// Au-delà de cette taille, le prétraitement est découpé en bandes parallèles
+const int kTiledSegmentationMinPixels = 2000000;
+// Hauteur minimale d'une bande (hors halo)
+const int kTiledSegmentationMinRows = 64;
+
+// Seuil d'Otsu sur un histogramme 8 bits (même calcul que cv::threshold THRESH_OTSU)
+int otsuThresholdFromHistogram(const int* hist, size_t total) {
+    double mu = 0.0;
+    double scale = 1.0 / static_cast<double>(total);
+    for (int i = 0; i < 256; i++) {
+        mu += i * static_cast<double>(hist[i]);
+    }
+    mu *= scale;
+    
+    double mu1 = 0.0, q1 = 0.0;
+    double max_sigma = 0.0;
+    int max_val = 0;
+    for (int i = 0; i < 256; i++) {
+        double p_i = hist[i] * scale;
+        mu1 *= q1;
+        q1 += p_i;
+        double q2 = 1.0 - q1;
+        if (std::min(q1, q2) < FLT_EPSILON || std::max(q1, q2) > 1.0 - FLT_EPSILON) {
+            continue;
         }
-        
-        // ÉTAPE 4: Analyse mesures
-        size_t best_contour_idx = valid_contours[0].second;
-        FootMeasurements foot_measurements = analyzeFootShapeAdaptive(
-            contours[best_contour_idx], calibration, img_bgr.size()
-        );
-        
-        // ÉTAPE 5: Image résultat
-        cv::Mat result = img_bgr.clone();
-        
-        // QR info
-        if (calibration.is_calibrated) {
-            cv::circle(result, calibration.qr_center, 15, cv::Scalar(0, 255, 0), -1);
-            std::string qr_info = "QR: " + std::to_string(calibration.qr_modules) + "M";
-            cv::putText(result, qr_info, 
-                       cv::Point(calibration.qr_center.x + 20, calibration.qr_center.y), 
-                       cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 0), 1);
+        mu1 = (mu1 + i * p_i) / q1;
+        double mu2 = (mu - q1 * mu1) / q2;
+        double sigma = q1 * q2 * (mu1 - mu2) * (mu1 - mu2);
+        if (sigma > max_sigma) {
+            max_sigma = sigma;
+            max_val = i;
         }
-        
-        // Contour et points
-        cv::drawContours(result, contours, best_contour_idx, cv::Scalar(255, 0, 0), 3);
-        cv::circle(result, foot_measurements.heel_point, 12, cv::Scalar(0, 255, 255), -1);
-        cv::circle(result, foot_measurements.toe_point, 12, cv::Scalar(0, 50, 255), -1);
-        cv::circle(result, foot_measurements.left_point, 12, cv::Scalar(255, 50, 0), -1);
-        cv::circle(result, foot_measurements.right_point, 12, cv::Scalar(255, 255, 0), -1);
-        
-        cv::line(result, foot_measurements.heel_point, foot_measurements.toe_point, cv::Scalar(255, 255, 255), 3);
-        cv::line(result, foot_measurements.left_point, foot_measurements.right_point, cv::Scalar(255, 255, 255), 3);
-        
-        // Texte info
-        int y = 40;
-        std::string length_text = "L: " + std::to_string(foot_measurements.length_cm).substr(0, 4) + "cm";
-        std::string width_text = "W: " + std::to_string(foot_measurements.width_cm).substr(0, 4) + "cm";
-        std::string method = foot_measurements.is_calibrated ? "QR ROBUSTE" : "ADAPTATIF";
-        
-        cv::putText(result, length_text, cv::Point(30, y), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 255), 2);
-        cv::putText(result, width_text, cv::Point(30, y+35), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 255), 2);
-        cv::putText(result, method, cv::Point(30, y+70), cv::FONT_HERSHEY_SIMPLEX, 0.6, 
-                   foot_measurements.is_calibrated ? cv::Scalar(0, 255, 0) : cv::Scalar(0, 150, 255), 2);
-        
-        // Encoder
-        std::vector<uchar> buf;
-        cv::imencode(".png", result, buf);
-        *outSize = static_cast<int>(buf.size());
-        
-        uint8_t* result_ptr = new uint8_t[*outSize];
-        std::memcpy(result_ptr, buf.data(), *outSize);
-        
-        LOGI("✅ measureFootWithQR terminée");
-        return result_ptr;
-        
-    } catch (const std::exception& e) {
-        LOGE("❌ Exception: %s", e.what());
-        *outSize = 0;
-        return nullptr;
     }
+    return max_val;
 }
 
-// FONCTION D'EXTRACTION DE MESURES
-__attribute__((visibility("default")))
-double* extractFootMeasurements(const char* path, double qr_size_cm) {
-    LOGI("🔍 extractFootMeasurements (QR: %.1f cm)", qr_size_cm);
+// Masque du pied en bandes horizontales parallèles, résultat identique à preprocessFootMask.
+// Passe 1 (par bande): flou + histogramme + somme du fond. Le flou d'une ROI lit les lignes
+//   voisines de l'image mère, donc sans halo explicite.
+// Réduction: seuil d'Otsu et polarité du fond, calculés une seule fois.
+// Passe 2 (par bande): seuil, fermeture puis ouverture sur la bande étendue d'un halo de
+//   4 rayons du noyau (2 érosions + 2 dilatations), seules les lignes centrales sont gardées.
+void preprocessFootMaskTiled(PipelineWorkspace& workspace, const cv::Mat& img_gray, const AdaptiveParams& params) {
+    const cv::Size size = img_gray.size();
+    const cv::Mat& border_mask = workspace.borderMask(size, params.border_width);
+    const cv::Mat& kernel = workspace.structuringElement(params.kernel_size);
+    cv::Mat& img_blurred = workspace.img_blurred;
+    cv::Mat& img_thresh = workspace.img_thresh;
+    img_blurred.create(size, CV_8UC1);
+    img_thresh.create(size, CV_8UC1);
     
-    double* measurements = new double[6];
-    for (int i = 0; i < 6; i++) measurements[i] = 0.0;
+    const int halo = 4 * std::max(kernel.rows / 2, kernel.cols / 2);
+    const int stripe_rows = std::max(kTiledSegmentationMinRows, 2 * halo);
+    const int stripe_count = std::max(1, std::min(size.height / stripe_rows, cv::getNumThreads() * 4));
     
-    try {
-        cv::Mat img_bgr = cv::imread(path, cv::IMREAD_COLOR);
-        if (img_bgr.empty()) {
-            LOGE("Image vide");
-            return measurements;
+    auto stripeRange = [&](int stripe) {
+        return cv::Range(stripe * size.height / stripe_count, (stripe + 1) * size.height / stripe_count);
+    };
+    
+    // Passe 1: flou, histogramme et statistiques du fond par bande
+    std::vector<std::vector<int>> histograms(stripe_count, std::vector<int>(256, 0));
+    std::vector<double> border_sums(stripe_count, 0.0);
+    std::vector<int> border_counts(stripe_count, 0);
+    
+    std::unique_ptr<StageTimer> timer(new StageTimer(workspace, FOOT_STAGE_BLUR));
+    cv::parallel_for_(cv::Range(0, stripe_count), [&](const cv::Range& range) {
+        for (int stripe = range.start; stripe < range.end; stripe++) {
+            cv::Range rows = stripeRange(stripe);
+            cv::Mat blurred = img_blurred.rowRange(rows);
+            cv::GaussianBlur(img_gray.rowRange(rows), blurred, cv::Size(5, 5), 0);
+            
+            int* hist = histograms[stripe].data();
+            double border_sum = 0.0;
+            int border_count = 0;
+            for (int y = 0; y < blurred.rows; y++) {
+                const uchar* pixel = blurred.ptr<uchar>(y);
+                const uchar* mask = border_mask.ptr<uchar>(rows.start + y);
+                for (int x = 0; x < blurred.cols; x++) {
+                    hist[pixel[x]]++;
+                    if (mask[x]) {
+                        border_sum += pixel[x];
+                        border_count++;
+                    }
+                }
+            }
+            border_sums[stripe] = border_sum;
+            border_counts[stripe] = border_count;
         }
-        
-        // Calibration QR
-        RobustCalibrationData calibration = detectRobustQRCalibration(img_bgr, qr_size_cm);
-        
-        // Détection simple du pied
-        cv::Mat img_gray;
-        cv::cvtColor(img_bgr, img_gray, cv::COLOR_BGR2GRAY);
-        cv::Mat img_blurred;
-        cv::GaussianBlur(img_gray, img_blurred, cv::Size(5, 5), 0);
-        
-        cv::Mat img_thresh;
-        cv::Scalar border_mean = cv::mean(img_blurred);
-        double background_intensity = border_mean[0];
-        
-        if (background_intensity > 128) {
-            cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
-        } else {
-            cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
-        }
-        
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-        cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_CLOSE, kernel);
-        cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_OPEN, kernel);
-        
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(img_thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        
-        if (!contours.empty()) {
-            auto max_contour = std::max_element(contours.begin(), contours.end(),
-                [](const auto& a, const auto& b) { return cv::contourArea(a) < cv::contourArea(b); });
+    }, stripe_count);
+    
+    // Réduction: seuil global et polarité
+    timer.reset(new StageTimer(workspace, FOOT_STAGE_THRESHOLD));
+    int hist[256] = {0};
+    double border_sum = 0.0;
+    int border_count = 0;
+    for (int stripe = 0; stripe < stripe_count; stripe++) {
+        for (int i = 0; i < 256; i++) hist[i] += histograms[stripe][i];
+        border_sum += border_sums[stripe];
+        border_count += border_counts[stripe];
+    }
+    double background_intensity = border_count > 0 ? border_sum / border_count : 0.0;
+    int otsu_threshold = otsuThresholdFromHistogram(hist, img_gray.total());
+    
+    workspace.mask_threshold = otsu_threshold;
+    workspace.mask_inverted = background_intensity > 128 && otsu_threshold > background_intensity * 0.7;
+    int threshold_type = cv::THRESH_BINARY;
+    if (workspace.mask_inverted) {
+        threshold_type = cv::THRESH_BINARY_INV;
+        LOGD("Fond clair détecté");
+    } else {
+        LOGD("Fond sombre détecté");
+    }
+    
+    // Passe 2: seuil + morphologie fusionnés par bande (données chaudes en cache)
+    timer.reset(new StageTimer(workspace, FOOT_STAGE_MORPHOLOGY));
+    cv::parallel_for_(cv::Range(0, stripe_count), [&](const cv::Range& range) {
+        cv::Mat tile;
+        for (int stripe = range.start; stripe < range.end; stripe++) {
+            cv::Range rows = stripeRange(stripe);
+            cv::Range padded(std::max(0, rows.start - halo), std::min(size.height, rows.end + halo));
             
-            FootMeasurements foot_measurements = analyzeFootShapeAdaptive(*max_contour, calibration, img_bgr.size());
+            cv::threshold(img_blurred.rowRange(padded), tile, otsu_threshold, 255, threshold_type);
+            cv::morphologyEx(tile, tile, cv::MORPH_CLOSE, kernel);
+            cv::morphologyEx(tile, tile, cv::MORPH_OPEN, kernel);
             
-            measurements[0] = foot_measurements.length_cm;
-            measurements[1] = foot_measurements.width_cm;
-            measurements[2] = foot_measurements.heel_to_arch_cm;
-            measurements[3] = foot_measurements.arch_to_toe_cm;
-            measurements[4] = foot_measurements.big_toe_length_cm;
-            measurements[5] = foot_measurements.is_calibrated ? 1.0 : 0.0;
+            cv::Mat thresh = img_thresh.rowRange(rows);
+            tile.rowRange(rows.start - padded.start, rows.end - padded.start).copyTo(thresh);
+        }
+    }, stripe_count);
+}
+
+// Boîte englobante d'une région (ligne label des statistiques de connectedComponentsWithStats)
+cv::Rect regionBoundingBox(const cv::Mat& stats, int label) {
+    const int* row = stats.ptr<int>(label);
+    return cv::Rect(row[cv::CC_STAT_LEFT], row[cv::CC_STAT_TOP], row[cv::CC_STAT_WIDTH], row[cv::CC_STAT_HEIGHT]);
+}
+
+// Contour externe d'une seule région, tracé dans sa boîte englobante (coordonnées image)
+// Une région 8-connexe n'a qu'un contour externe; le plus long est gardé par sécurité.
+bool traceRegionContour(const cv::Mat& labels, const cv::Mat& stats, int label,
+                        cv::Mat& region_mask, std::vector<cv::Point>& contour) {
+    cv::Rect bbox = regionBoundingBox(stats, label);
+    cv::compare(labels(bbox), cv::Scalar(label), region_mask, cv::CMP_EQ);
+    
+    std::vector<std::vector<cv::Point>> traced;
+    cv::findContours(region_mask, traced, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, bbox.tl());
+    if (traced.empty()) return false;
+    
+    auto longest = std::max_element(traced.begin(), traced.end(),
+        [](const auto& a, const auto& b) { return a.size() < b.size(); });
+    contour.swap(*longest);
+    return true;
+}
+
+// Régions du masque en une passe (étiquetage parallèle d'OpenCV): aire, boîte et centroïde par région
+// Retourne le nombre d'étiquettes, fond (0) compris.
+int labelFootRegions(PipelineWorkspace& workspace, const cv::Mat& mask) {
+    StageTimer timer(workspace, FOOT_STAGE_CONTOURS);
+    return cv::connectedComponentsWithStats(mask, workspace.component_labels, workspace.component_stats,
+                                            workspace.component_centroids, 8, CV_32S, cv::CCL_DEFAULT);
+}
+
+// Trace la région retenue: workspace.contours = { contour }
+bool traceFootRegion(PipelineWorkspace& workspace, int label) {
+    StageTimer timer(workspace, FOOT_STAGE_CONTOURS);
+    workspace.contours.resize(1);
+    return traceRegionContour(workspace.component_labels, workspace.component_stats, label,
+                              workspace.component_mask, workspace.contours[0]);
+}
+
+// Filtrage adaptatif des régions étiquetées: candidats triés par aire dans workspace.candidate_regions
+bool filterFootComponents(PipelineWorkspace& workspace, const cv::Size& image_size,
+                          const AdaptiveParams& params, int& best_label) {
+    StageTimer timer(workspace, FOOT_STAGE_FILTER);
+    const cv::Mat& stats = workspace.component_stats;
+    std::vector<std::pair<double, int>>& candidates = workspace.candidate_regions;
+    candidates.clear();
+    double total_area = image_size.area();
+    double min_area = total_area * params.min_contour_area_ratio;
+    double max_area = total_area * params.max_contour_area_ratio;
+    
+    for (int label = 1; label < stats.rows; label++) {
+        double area = stats.at<int>(label, cv::CC_STAT_AREA);
+        if (area > min_area && area < max_area) {
+            cv::Rect bbox = regionBoundingBox(stats, label);
+            bool near_border = (bbox.x < params.border_width || 
+                               bbox.y < params.border_width ||
+                               bbox.x + bbox.width > image_size.width - params.border_width ||
+                               bbox.y + bbox.height > image_size.height - params.border_width);
             
-            LOGI("✅ Extraction réussie");
-        } else {
-            LOGE("Aucun contour détecté");
+            if (!near_border || area > total_area * 0.3) {
+                candidates.push_back(std::make_pair(area, label));
+            }
         }
-        
-        return measurements;
-    } catch (const std::exception& e) {
-        LOGE("Exception extractFootMeasurements: %s", e.what());
-        return measurements;
     }
+    
+    std::sort(candidates.begin(), candidates.end(), 
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+    
+    if (candidates.empty()) {
+        LOGE("Aucun contour valide");
+        return false;
+    }
+    
+    best_label = candidates[0].second;
+    const double* centroid = workspace.component_centroids.ptr<double>(best_label);
+    LOGD("🦶 Région retenue: %.0f px, centre (%.0f, %.0f), %zu candidates / %d régions",
+         candidates[0].first, centroid[0], centroid[1], candidates.size(), stats.rows - 1);
+    return true;
 }
 
-// FONCTIONS EXISTANTES (inchangées)
+// Masque adaptatif, étiquetage et choix de la région du pied sur ses statistiques (sans tracé)
+bool segmentFootRegions(PipelineWorkspace& workspace, const cv::Mat& img_gray,
+                        const AdaptiveParams& params, int& best_label) {
+    if (static_cast<int>(img_gray.total()) >= kTiledSegmentationMinPixels && cv::getNumThreads() > 1) {
+        preprocessFootMaskTiled(workspace, img_gray, params);
+    } else {
+        preprocessFootMask(workspace, img_gray, params);
+    }
+    
+    if (labelFootRegions(workspace, workspace.img_thresh) <= 1) {
+        LOGE("Aucun contour");
+        return false;
+    }
+    
+    return filterFootComponents(workspace, img_gray.size(), params, best_label);
+}
+
+// Segmentation adaptative du pied: régions candidates, puis tracé de la seule région retenue
+// (workspace.contours[best_contour_idx])
+bool segmentFootAdaptive(PipelineWorkspace& workspace, const cv::Mat& img_gray,
+                         const AdaptiveParams& params, size_t& best_contour_idx) {
+    workspace.contours.clear();
+    int best_label = 0;
+    if (!segmentFootRegions(workspace, img_gray, params, best_label) ||
+        !traceFootRegion(workspace, best_label)) {
+        return false;
+    }
+    
+    best_contour_idx = 0;
+    return true;
+}
+
+// Segmentation grossière: grand côté ramené à kCoarseSegmentationLongEdge, utilisée dès que
+// l'image fait au moins le double; points extrêmes ensuite affinés en pleine résolution
+const int kCoarseSegmentationLongEdge = 1024;
+// Recentrages maximum d'une fenêtre d'affinage (pied coupé par le bord de la fenêtre)
+const int kRefineMaxIterations = 4;
+
+bool useCoarseSegmentation(const cv::Size& size) {
+    return std::max(size.width, size.height) >= 2 * kCoarseSegmentationLongEdge;
+}
+
+// Image réduite de la segmentation grossière (workspace.img_coarse)
+const cv::Mat& coarseSegmentationImage(PipelineWorkspace& workspace, const cv::Mat& img_gray) {
+    double scale = static_cast<double>(kCoarseSegmentationLongEdge) / std::max(img_gray.cols, img_gray.rows);
+    StageTimer timer(workspace, FOOT_STAGE_BLUR);
+    cv::resize(img_gray, workspace.img_coarse, cv::Size(), scale, scale, cv::INTER_AREA);
+    return workspace.img_coarse;
+}
+
+// Contour de l'image réduite ramené en pixels pleine résolution (centre du pixel grossier projeté)
+void scaleCoarseContour(std::vector<cv::Point>& contour, const cv::Size& coarse_size, const cv::Size& full_size) {
+    double sx = static_cast<double>(full_size.width) / coarse_size.width;
+    double sy = static_cast<double>(full_size.height) / coarse_size.height;
+    for (auto& point : contour) {
+        point.x = std::min(full_size.width - 1, cvRound((point.x + 0.5) * sx - 0.5));
+        point.y = std::min(full_size.height - 1, cvRound((point.y + 0.5) * sy - 0.5));
+    }
+}
+
+// Segmentation sur l'image réduite; workspace.contours est ramené en pixels pleine résolution
+bool segmentFootCoarse(PipelineWorkspace& workspace, const cv::Mat& img_gray, size_t& best_contour_idx) {
+    const cv::Mat& img_coarse = coarseSegmentationImage(workspace, img_gray);
+    AdaptiveParams coarse_params(img_coarse.size());
+    if (!segmentFootAdaptive(workspace, img_coarse, coarse_params, best_contour_idx)) {
+        return false;
+    }
+    
+    for (auto& contour : workspace.contours) {
+        scaleCoarseContour(contour, img_coarse.size(), img_gray.size());
+    }
+    return true;
+}
+
+// Affine un point extrême dans une fenêtre pleine résolution centrée sur seed: flou, seuil (même
+// seuil et polarité que le masque grossier) et morphologie comme le pipeline pleine résolution,
+// puis pixel du pied le plus loin dans la direction (unitaire) de recherche.
+// La fenêtre est recentrée tant que le pied en touche un bord situé dans cette direction.
+cv::Point refineExtremePoint(PipelineWorkspace& workspace, const cv::Mat& img_gray, const cv::Mat& kernel,
+                             const cv::Point& seed, const cv::Point2f& direction, int radius) {
+    const cv::Rect bounds(0, 0, img_gray.cols, img_gray.rows);
+    const int pad = 2 + 4 * std::max(kernel.rows / 2, kernel.cols / 2);
+    const int threshold_type = workspace.mask_inverted ? cv::THRESH_BINARY_INV : cv::THRESH_BINARY;
+    cv::Point center = seed;
+    cv::Point best = seed;
+    
+    for (int iteration = 0; iteration < kRefineMaxIterations; iteration++) {
+        cv::Rect window = cv::Rect(center.x - radius, center.y - radius, 2 * radius + 1, 2 * radius + 1) & bounds;
+        cv::Rect padded = cv::Rect(window.x - pad, window.y - pad, window.width + 2 * pad, window.height + 2 * pad) & bounds;
+        
+        cv::GaussianBlur(img_gray(padded), workspace.refine_blurred, cv::Size(5, 5), 0);
+        cv::threshold(workspace.refine_blurred, workspace.refine_mask, workspace.mask_threshold, 255, threshold_type);
+        cv::morphologyEx(workspace.refine_mask, workspace.refine_mask, cv::MORPH_CLOSE, kernel);
+        cv::morphologyEx(workspace.refine_mask, workspace.refine_mask, cv::MORPH_OPEN, kernel);
+        const cv::Mat mask = workspace.refine_mask(window - padded.tl());
+        
+        // Projection maximale sur la direction; à égalité, le plus proche de seed
+        bool found = false;
+        float best_score = 0.0f;
+        int best_distance = 0;
+        cv::Point candidate;
+        for (int y = 0; y < mask.rows; y++) {
+            const uchar* row = mask.ptr<uchar>(y);
+            for (int x = 0; x < mask.cols; x++) {
+                if (row[x] == 0) continue;
+                cv::Point point(window.x + x, window.y + y);
+                float score = point.x * direction.x + point.y * direction.y;
+                int distance = std::abs(point.x - seed.x) + std::abs(point.y - seed.y);
+                if (!found || score > best_score + 1e-4f ||
+                    (score > best_score - 1e-4f && distance < best_distance)) {
+                    found = true;
+                    best_score = score;
+                    best_distance = distance;
+                    candidate = point;
+                }
+            }
+        }
+        if (!found) return best;
+        best = candidate;
+        
+        // Pied coupé par un bord de la fenêtre (et non de l'image) faisant face à la direction: recentrer
+        bool on_window_edge =
+            (direction.x > 0 && best.x == window.br().x - 1 && window.br().x < img_gray.cols) ||
+            (direction.x < 0 && best.x == window.x && window.x > 0) ||
+            (direction.y > 0 && best.y == window.br().y - 1 && window.br().y < img_gray.rows) ||
+            (direction.y < 0 && best.y == window.y && window.y > 0);
+        if (!on_window_edge) return best;
+        center = best;
+    }
+    return best;
+}
+
+// Points extrêmes (pleine résolution, issus d'un contour segmenté en réduit) affinés localement
+// le long de l'axe du pied; coarse_scale: facteur réduit -> pleine résolution du contour
+ExtremePoints refineExtremePoints(PipelineWorkspace& workspace, const cv::Mat& img_gray,
+                                  const AdaptiveParams& params, const ExtremePoints& seeds, const FootAxis& axis,
+                                  double coarse_scale) {
+    const cv::Mat& kernel = workspace.structuringElement(params.kernel_size);
+    int radius = cvCeil(2.0 * coarse_scale) + kernel.cols + 4;
+    
+    ExtremePoints extremes;
+    extremes.bottom = refineExtremePoint(workspace, img_gray, kernel, seeds.bottom, axis.along, radius);
+    extremes.top = refineExtremePoint(workspace, img_gray, kernel, seeds.top, -axis.along, radius);
+    extremes.left = refineExtremePoint(workspace, img_gray, kernel, seeds.left, -axis.across, radius);
+    extremes.right = refineExtremePoint(workspace, img_gray, kernel, seeds.right, axis.across, radius);
+    return extremes;
+}
+
+// Localisation sous-pixel: profil d'intensité le long de la direction de recherche, moyenné
+// sur kEdgeProfileHalfWidth pixels de part et d'autre, dérivée centrale puis sommet parabolique
+// du module du gradient dans ±kEdgeSearchRadius pixels autour du point du contour
+const int kEdgeSearchRadius = 4;
+const int kEdgeProfileHalfWidth = 2;
+
+// Bord sous-pixel autour de point (pixel du pied le plus loin dans la direction unitaire).
+// Le point n'est déplacé que le long de la direction; inchangé près du bord de l'image.
+cv::Point2f subpixelEdgePoint(PipelineWorkspace& workspace, const cv::Mat& img_gray,
+                              const cv::Point& point, const cv::Point2f& direction) {
+    const int reach = kEdgeSearchRadius + 1;
+    const cv::Point2f origin(static_cast<float>(point.x), static_cast<float>(point.y));
+    const cv::Point2f normal(-direction.y, direction.x);
+    
+    // Bande échantillonnée: colonne k le long de la direction, ligne j en travers
+    cv::Point2f corner = origin - direction * static_cast<float>(reach) - normal * static_cast<float>(kEdgeProfileHalfWidth);
+    cv::Point2f corners[4] = {
+        corner,
+        corner + direction * static_cast<float>(2 * reach),
+        corner + normal * static_cast<float>(2 * kEdgeProfileHalfWidth),
+        corner + direction * static_cast<float>(2 * reach) + normal * static_cast<float>(2 * kEdgeProfileHalfWidth)
+    };
+    for (const auto& c : corners) {
+        if (c.x < 0 || c.y < 0 || c.x > img_gray.cols - 1 || c.y > img_gray.rows - 1) return origin;
+    }
+    
+    // Profil moyen (2 * reach + 1 valeurs, indice reach = point); pixels exacts si l'axe est aligné
+    cv::Matx23d transform(direction.x, normal.x, corner.x,
+                          direction.y, normal.y, corner.y);
+    cv::warpAffine(img_gray, workspace.edge_strip, transform,
+                   cv::Size(2 * reach + 1, 2 * kEdgeProfileHalfWidth + 1),
+                   cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_REPLICATE);
+    cv::reduce(workspace.edge_strip, workspace.edge_profile, 0, cv::REDUCE_AVG, CV_32F);
+    const float* profile = workspace.edge_profile.ptr<float>();
+    
+    // À égalité de gradient, le plus proche du point du contour
+    float gradient[2 * kEdgeSearchRadius + 1];
+    int best = -1;
+    for (int k = 0; k <= 2 * kEdgeSearchRadius; k++) {
+        int index = reach - kEdgeSearchRadius + k;
+        gradient[k] = std::abs(profile[index + 1] - profile[index - 1]);
+        if (best < 0 || gradient[k] > gradient[best] ||
+            (gradient[k] == gradient[best] && std::abs(k - kEdgeSearchRadius) < std::abs(best - kEdgeSearchRadius))) {
+            best = k;
+        }
+    }
+    
+    float offset = static_cast<float>(best - kEdgeSearchRadius);
+    if (best > 0 && best < 2 * kEdgeSearchRadius) {
+        float left = gradient[best - 1], center = gradient[best], right = gradient[best + 1];
+        float curvature = left - 2.0f * center + right;
+        if (curvature < 0.0f) {
+            offset += std::max(-0.5f, std::min(0.5f, 0.5f * (left - right) / curvature));
+        }
+    }
+    if (gradient[best] <= 0.0f) offset = 0.0f;
+    
+    return origin + direction * offset;
+}
+
+SubpixelExtremePoints subpixelExtremePoints(PipelineWorkspace& workspace, const cv::Mat& img_gray,
+                                            const ExtremePoints& extremes, const FootAxis& axis) {
+    SubpixelExtremePoints points;
+    points.bottom = subpixelEdgePoint(workspace, img_gray, extremes.bottom, axis.along);
+    points.top = subpixelEdgePoint(workspace, img_gray, extremes.top, -axis.along);
+    points.left = subpixelEdgePoint(workspace, img_gray, extremes.left, -axis.across);
+    points.right = subpixelEdgePoint(workspace, img_gray, extremes.right, axis.across);
+    return points;
+}
+
+// Image résultat annotée (QR, contour, points extrêmes, texte) écrite dans result
+void drawFootAnnotations(const cv::Mat& img_bgr,
+                         const std::vector<std::vector<cv::Point>>& contours,
+                         size_t best_contour_idx,
+                         const RobustCalibrationData& calibration,
+                         const FootMeasurements& foot_measurements,
+                         cv::Mat& result) {
+    img_bgr.copyTo(result);
+    
+    // QR info
+    if (calibration.is_calibrated) {
+        cv::circle(result, calibration.qr_center, 15, cv::Scalar(0, 255, 0), -1);
+        std::string qr_info = "QR: " + std::to_string(calibration.qr_modules) + "M";
+        cv::putText(result, qr_info, 
+                   cv::Point(calibration.qr_center.x + 20, calibration.qr_center.y), 
+                   cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 0), 1);
+    }
+    
+    // Contour et points
+    cv::drawContours(result, contours, best_contour_idx, cv::Scalar(255, 0, 0), 3);
+    cv::circle(result, foot_measurements.heel_point, 12, cv::Scalar(0, 255, 255), -1);
+    cv::circle(result, foot_measurements.toe_point, 12, cv::Scalar(0, 50, 255), -1);
+    cv::circle(result, foot_measurements.left_point, 12, cv::Scalar(255, 50, 0), -1);
+    cv::circle(result, foot_measurements.right_point, 12, cv::Scalar(255, 255, 0), -1);
+    
+    cv::line(result, foot_measurements.heel_point, foot_measurements.toe_point, cv::Scalar(255, 255, 255), 3);
+    cv::line(result, foot_measurements.left_point, foot_measurements.right_point, cv::Scalar(255, 255, 255), 3);
+    
+    // Texte info
+    int y = 40;
+    std::string length_text = "L: " + std::to_string(foot_measurements.length_cm).substr(0, 4) + "cm";
+    std::string width_text = "W: " + std::to_string(foot_measurements.width_cm).substr(0, 4) + "cm";
+    std::string method = foot_measurements.is_calibrated ? "QR ROBUSTE" : "ADAPTATIF";
+    
+    cv::putText(result, length_text, cv::Point(30, y), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 255), 2);
+    cv::putText(result, width_text, cv::Point(30, y+35), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 255), 2);
+    cv::putText(result, method, cv::Point(30, y+70), cv::FONT_HERSHEY_SIMPLEX, 0.6, 
+               foot_measurements.is_calibrated ? cv::Scalar(0, 255, 0) : cv::Scalar(0, 150, 255), 2);
+}
+
+// Qualité JPEG quand FootEncodeOptions.jpeg_quality vaut 0
+const int kDefaultJpegQuality = 90;
+
+// Options d'encodage valides (nullptr accepté: PNG pleine résolution)
+bool validEncodeOptions(const FootEncodeOptions* options) {
+    if (options != nullptr && options->struct_size < sizeof(FootEncodeOptions)) {
+        LOGE("❌ FootEncodeOptions trop petit: %u < %u octets",
+             options->struct_size, static_cast<unsigned>(sizeof(FootEncodeOptions)));
+        return false;
+    }
+    return true;
+}
+
+// Image résultat selon les options (buf: tampon d'encodage réutilisable)
+// options nul: PNG pleine résolution. Sinon réduction éventuelle à max_dimension, puis
+// PNG, JPEG ou pixels RGBA bruts; output_width/output_height reçoivent la taille produite.
+// outHandle nul: copie libérable par freeMemory.
+// outHandle non nul: le tampon encodé est cédé sans copie; il reste valide jusqu'à
+// releaseImageBuffer(*outHandle), utilisable comme NativeFinalizer côté Dart.
+uint8_t* encodeResultImageWith(std::vector<uchar>& buf, const cv::Mat& image, FootEncodeOptions* options,
+                               int* outSize, void** outHandle) {
+    if (options == nullptr) {
+        cv::imencode(".png", image, buf);
+    } else {
+        // Aperçu: réduction avant encodage, jamais d'agrandissement
+        cv::Mat output = image;
+        int long_edge = std::max(image.cols, image.rows);
+        if (options->max_dimension > 0 && long_edge > options->max_dimension) {
+            double scale = static_cast<double>(options->max_dimension) / long_edge;
+            cv::resize(image, output, cv::Size(), scale, scale, cv::INTER_AREA);
+        }
+        options->output_width = output.cols;
+        options->output_height = output.rows;
+        
+        switch (options->format) {
+            case FOOT_IMAGE_RGBA: {
+                // Conversion directement dans le tampon de sortie (lignes contiguës)
+                buf.resize(output.total() * 4);
+                cv::Mat rgba(output.rows, output.cols, CV_8UC4, buf.data());
+                cv::cvtColor(output, rgba, output.channels() == 1 ? cv::COLOR_GRAY2RGBA : cv::COLOR_BGR2RGBA);
+                break;
+            }
+            case FOOT_IMAGE_JPEG: {
+                int quality = options->jpeg_quality > 0 ? std::min(options->jpeg_quality, 100) : kDefaultJpegQuality;
+                cv::imencode(".jpg", output, buf, {cv::IMWRITE_JPEG_QUALITY, quality});
+                break;
+            }
+            default: {
+                std::vector<int> params;
+                if (options->png_compression >= 0) {
+                    params = {cv::IMWRITE_PNG_COMPRESSION, std::min(options->png_compression, 9)};
+                }
+                cv::imencode(".png", output, buf, params);
+                break;
+            }
+        }
+    }
+    *outSize = static_cast<int>(buf.size());
+    
+    if (outHandle != nullptr) {
+        std::vector<uchar>* owned = new std::vector<uchar>();
+        owned->swap(buf);
+        *outHandle = owned;
+        return owned->data();
+    }
+    
+    uint8_t* result_ptr = new uint8_t[*outSize];
+    std::memcpy(result_ptr, buf.data(), *outSize);
+    return result_ptr;
+}
+
+uint8_t* encodeResultImage(const cv::Mat& image, FootEncodeOptions* options, int* outSize, void** outHandle) {
+    std::vector<uchar> buf;
+    return encodeResultImageWith(buf, image, options, outSize, outHandle);
+}
+
+// Taille de la version 1 de FootMeasurementResult (sans stage_ms)
+const size_t kFootMeasurementResultV1Size = offsetof(FootMeasurementResult, stage_ms);
+
+// Remise à zéro d'un FootMeasurementResult fourni par l'appelant (voir native_opencv.h)
+bool resetMeasurementResult(FootMeasurementResult* out) {
+    if (out == nullptr) {
+        return false;
+    }
+    if (out->struct_size < kFootMeasurementResultV1Size) {
+        LOGE("❌ FootMeasurementResult trop petit: %u < %u octets",
+             out->struct_size, static_cast<unsigned>(kFootMeasurementResultV1Size));
+        return false;
+    }
+    
+    // Appelant compilé avec un en-tête plus ancien: seuls ses champs sont écrits
+    uint32_t struct_size = out->struct_size;
+    std::memset(out, 0, std::min<size_t>(struct_size, sizeof(FootMeasurementResult)));
+    out->struct_size = struct_size;
+    out->version = struct_size >= sizeof(FootMeasurementResult) ? FOOT_MEASUREMENT_RESULT_VERSION : 1;
+    out->perspective_ratio = 1.0;
+    return true;
+}
+
+// Calibration seule (renseignée même si aucun pied n'est trouvé)
+void fillCalibrationResult(const RobustCalibrationData& calibration, FootMeasurementResult* out) {
+    out->is_calibrated = calibration.is_calibrated ? 1 : 0;
+    out->pixels_per_cm = calibration.pixels_per_cm;
+    out->qr_center_x = calibration.qr_center.x;
+    out->qr_center_y = calibration.qr_center.y;
+    out->qr_size_pixels_raw = calibration.qr_size_pixels_raw;
+    out->qr_size_pixels_corrected = calibration.qr_size_pixels_corrected;
+    out->perspective_ratio = calibration.perspective_ratio;
+    out->qr_modules = calibration.qr_modules;
+    
+    size_t length = std::min(calibration.qr_content.size(), static_cast<size_t>(FOOT_QR_CONTENT_MAX - 1));
+    std::memcpy(out->qr_content, calibration.qr_content.data(), length);
+    out->qr_content[length] = '\0';
+    out->qr_content_length = static_cast<int32_t>(length);
+}
+
+// Mesures, points clés et calibration d'un pied trouvé
+void fillMeasurementResult(const FootMeasurements& foot_measurements,
+                           const RobustCalibrationData& calibration,
+                           const cv::Size& image_size,
+                           FootMeasurementResult* out) {
+    fillCalibrationResult(calibration, out);
+    out->found = 1;
+    out->is_calibrated = foot_measurements.is_calibrated ? 1 : 0;
+    out->image_width = image_size.width;
+    out->image_height = image_size.height;
+    
+    out->length_cm = foot_measurements.length_cm;
+    out->width_cm = foot_measurements.width_cm;
+    out->heel_to_arch_cm = foot_measurements.heel_to_arch_cm;
+    out->arch_to_toe_cm = foot_measurements.arch_to_toe_cm;
+    out->big_toe_length_cm = foot_measurements.big_toe_length_cm;
+    
+    out->heel_x = foot_measurements.heel_point.x;
+    out->heel_y = foot_measurements.heel_point.y;
+    out->toe_x = foot_measurements.toe_point.x;
+    out->toe_y = foot_measurements.toe_point.y;
+    out->left_x = foot_measurements.left_point.x;
+    out->left_y = foot_measurements.left_point.y;
+    out->right_x = foot_measurements.right_point.x;
+    out->right_y = foot_measurements.right_point.y;
+}
+
+// Mesures d'un contour pleine résolution: axe principal et profil, points extrêmes le long de l'axe
+// (affinés en pleine résolution si le contour vient d'une segmentation réduite, coarse_scale > 1),
+// puis localisés au sous-pixel sur le gradient de l'image
+FootMeasurements measureFootContour(PipelineWorkspace& workspace, const cv::Mat& img_gray,
+                                    const std::vector<cv::Point>& contour, double coarse_scale,
+                                    const RobustCalibrationData& calibration) {
+    StageTimer timer(workspace, FOOT_STAGE_MEASURE);
+    FootProfile profile;
+    FootAxis axis = analyzeFootAxis(contour, profile);
+    ExtremePoints extremes = getAxisExtremePoints(contour, axis);
+    if (coarse_scale > 1.0) {
+        extremes = refineExtremePoints(workspace, img_gray, workspace.adaptiveParams(img_gray.size()), extremes, axis,
+                                       coarse_scale);
+    }
+    return analyzeFootExtremes(subpixelExtremePoints(workspace, img_gray, extremes, axis),
+                               axis, profile, calibration, img_gray.size());
+}
+
+// Calibration, segmentation et mesures sur une image en niveaux de gris
+// Le contour retenu est workspace.contours[best_contour_idx].
+bool analyzeFootFromGray(PipelineWorkspace& workspace, const cv::Mat& img_gray, double qr_size_cm,
+                         RobustCalibrationData& calibration,
+                         size_t& best_contour_idx,
+                         FootMeasurements& foot_measurements) {
+    // ÉTAPE 1: Calibration QR robuste
+    calibration = detectRobustQRCalibrationWith(workspace, img_gray, qr_size_cm);
+    
+    // ÉTAPE 2: Paramètres adaptatifs
+    const AdaptiveParams& params = workspace.adaptiveParams(img_gray.size());
+    
+    // ÉTAPE 3: Détection adaptative du pied (image réduite pour les grandes images)
+    bool coarse = useCoarseSegmentation(img_gray.size());
+    bool segmented = coarse ? segmentFootCoarse(workspace, img_gray, best_contour_idx)
+                            : segmentFootAdaptive(workspace, img_gray, params, best_contour_idx);
+    if (!segmented) {
+        return false;
+    }
+    
+    // ÉTAPE 4: Analyse mesures
+    double coarse_scale = coarse ? static_cast<double>(img_gray.cols) / workspace.img_coarse.cols : 1.0;
+    foot_measurements = measureFootContour(workspace, img_gray, workspace.contours[best_contour_idx],
+                                           coarse_scale, calibration);
+    return true;
+}
+
+// Pipeline complet sur une image décodée: calibration, segmentation, mesures, annotation
+uint8_t* runFootMeasurementPipeline(PipelineWorkspace& workspace, const cv::Mat& img_bgr, double qr_size_cm,
+                                    FootEncodeOptions* options, int* outSize, void** outHandle,
+                                    FootMeasurementResult* outResult) {
+    LOGD("📸 Image: %dx%d (%.1fMP)", img_bgr.cols, img_bgr.rows, 
+         (img_bgr.cols * img_bgr.rows) / 1000000.0);
+    
+    // Une seule conversion: le détecteur QR et la segmentation travaillent en niveaux de gris
+    cv::Mat& img_gray = workspace.img_gray;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_GRAY);
+        cv::cvtColor(img_bgr, img_gray, cv::COLOR_BGR2GRAY);
+    }
+    
+    RobustCalibrationData calibration;
+    size_t best_contour_idx = 0;
+    FootMeasurements foot_measurements;
+    if (!analyzeFootFromGray(workspace, img_gray, qr_size_cm, calibration, best_contour_idx, foot_measurements)) {
+        if (outResult != nullptr) fillCalibrationResult(calibration, outResult);
+        *outSize = 0;
+        return nullptr;
+    }
+    if (outResult != nullptr) {
+        fillMeasurementResult(foot_measurements, calibration, img_gray.size(), outResult);
+    }
+    
+    // ÉTAPE 5: Image résultat
+    {
+        StageTimer timer(workspace, FOOT_STAGE_DRAW);
+        drawFootAnnotations(img_bgr, workspace.contours, best_contour_idx, calibration, foot_measurements, workspace.result);
+    }
+    
+    // Encoder
+    StageTimer timer(workspace, FOOT_STAGE_ENCODE);
+    return encodeResultImageWith(workspace.encode_buffer, workspace.result, options, outSize, outHandle);
+}
+
+// Lecture d'une image disque, chronométrée
+cv::Mat loadImageWith(PipelineWorkspace& workspace, const char* path) {
+    StageTimer timer(workspace, FOOT_STAGE_DECODE);
+    return cv::imread(path, cv::IMREAD_COLOR);
+}
+
+// FONCTION PRINCIPALE ROBUSTE
 __attribute__((visibility("default")))
-uint8_t* processImage(const char* path, int* outSize) {
-    LOGI("processImage appelée");
+uint8_t* measureFootWithQR(const char* path, int* outSize, double qr_size_cm) {
+    LOGI("🔍 measureFootWithQR robuste (QR: %.1f cm)", qr_size_cm);
     
     if (path == nullptr || outSize == nullptr) {
         LOGE("Paramètres invalides");
@@ -538,158 +1497,2286 @@ uint8_t* processImage(const char* path, int* outSize) {
     }
     
     try {
-        cv::Mat image = cv::imread(path, cv::IMREAD_COLOR);
-        if (image.empty()) {
-            LOGE("Impossible de charger l'image: %s", path);
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, nullptr);
+        cv::Mat img_bgr = loadImageWith(workspace, path);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
             *outSize = 0;
             return nullptr;
         }
         
-        cv::Mat gray, edges;
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-        cv::Canny(gray, edges, 100, 200);
-
-        std::vector<uchar> buf;
-        cv::imencode(".png", edges, buf);
-        *outSize = static_cast<int>(buf.size());
-
-        uint8_t* result = new uint8_t[*outSize];
-        std::memcpy(result, buf.data(), *outSize);
+        uint8_t* result_ptr = runFootMeasurementPipeline(workspace, img_bgr, qr_size_cm, nullptr, outSize, nullptr, nullptr);
+        if (result_ptr != nullptr) {
+            LOGI("✅ measureFootWithQR terminée");
+        }
+        return result_ptr;
         
-        return result;
     } catch (const std::exception& e) {
-        LOGE("Exception processImage: %s", e.what());
+        LOGE("❌ Exception: %s", e.what());
         *outSize = 0;
         return nullptr;
     }
 }
 
+// FONCTION FUSIONNÉE: image annotée + mesures en un seul décodage/QR/segmentation
+// outResult: structure fournie par l'appelant (struct_size renseigné), remise à zéro puis remplie
 __attribute__((visibility("default")))
-uint8_t* removeBackground(const char* path, int* outSize) {
-    LOGI("removeBackground appelée");
+uint8_t* processFootWithQR(const char* path, int* outSize, double qr_size_cm, FootMeasurementResult* outResult) {
+    LOGI("🚀 processFootWithQR (QR: %.1f cm)", qr_size_cm);
     
-    if (path == nullptr || outSize == nullptr) {
+    if (path == nullptr || outSize == nullptr || !resetMeasurementResult(outResult)) {
         LOGE("Paramètres invalides");
-        *outSize = 0;
+        if (outSize != nullptr) *outSize = 0;
         return nullptr;
     }
     
+    *outSize = 0;
+    
     try {
-        cv::Mat img_bgr = cv::imread(path, cv::IMREAD_COLOR);
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, outResult);
+        cv::Mat img_bgr = loadImageWith(workspace, path);
         if (img_bgr.empty()) {
             LOGE("Image vide");
-            *outSize = 0;
             return nullptr;
         }
         
-        cv::Mat img_gray;
-        cv::cvtColor(img_bgr, img_gray, cv::COLOR_BGR2GRAY);
-        cv::Mat img_blurred;
-        cv::GaussianBlur(img_gray, img_blurred, cv::Size(5, 5), 0);
-        
-        cv::Mat border_mask = cv::Mat::zeros(img_gray.size(), CV_8UC1);
-        int border_width = std::min(img_gray.rows, img_gray.cols) / 10;
+        uint8_t* result_ptr = runFootMeasurementPipeline(workspace, img_bgr, qr_size_cm, nullptr, outSize, nullptr, outResult);
+        if (result_ptr == nullptr) {
+            return nullptr;
+        }
         
-        cv::rectangle(border_mask, cv::Point(0, 0), cv::Point(img_gray.cols, border_width), cv::Scalar(255), -1);
-        cv::rectangle(border_mask, cv::Point(0, img_gray.rows - border_width), cv::Point(img_gray.cols, img_gray.rows), cv::Scalar(255), -1);
-        cv::rectangle(border_mask, cv::Point(0, 0), cv::Point(border_width, img_gray.rows), cv::Scalar(255), -1);
-        cv::rectangle(border_mask, cv::Point(img_gray.cols - border_width, 0), cv::Point(img_gray.cols, img_gray.rows), cv::Scalar(255), -1);
+        LOGI("✅ processFootWithQR terminée");
+        return result_ptr;
         
-        cv::Scalar border_mean = cv::mean(img_blurred, border_mask);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception processFootWithQR: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+// Extraction simple des mesures sur une image décodée (out déjà remis à zéro par l'appelant)
+bool extractMeasurementsFromImage(PipelineWorkspace& workspace, const cv::Mat& img_bgr, double qr_size_cm,
+                                  FootMeasurementResult* out) {
+    // Calibration QR
+    RobustCalibrationData calibration = detectRobustQRCalibrationWith(workspace, img_bgr, qr_size_cm);
+    fillCalibrationResult(calibration, out);
+    
+    // Détection simple du pied
+    cv::Mat img_gray;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_GRAY);
+        cv::cvtColor(img_bgr, img_gray, cv::COLOR_BGR2GRAY);
+    }
+    cv::Mat img_blurred;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_BLUR);
+        cv::GaussianBlur(img_gray, img_blurred, cv::Size(5, 5), 0);
+    }
+    
+    cv::Mat img_thresh;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_THRESHOLD);
+        cv::Scalar border_mean = cv::mean(img_blurred);
         double background_intensity = border_mean[0];
         
-        cv::Mat img_thresh;
-        double otsu_threshold = cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
-        
-        if (background_intensity > 128 && otsu_threshold > background_intensity * 0.7) {
+        if (background_intensity > 128) {
             cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+        } else {
+            cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
         }
-        
+    }
+    
+    {
+        StageTimer timer(workspace, FOOT_STAGE_MORPHOLOGY);
         cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
         cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_CLOSE, kernel);
         cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_OPEN, kernel);
-        
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(img_thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        
-        if (contours.empty()) {
-            *outSize = 0;
-            return nullptr;
-        }
-
-        std::vector<std::pair<double, size_t>> valid_contours;
-        double total_area = img_gray.rows * img_gray.cols;
-        
-        for (size_t i = 0; i < contours.size(); i++) {
-            double area = cv::contourArea(contours[i]);
-            if (area > total_area * 0.01 && area < total_area * 0.8) {
-                cv::Rect bbox = cv::boundingRect(contours[i]);
-                bool near_border = (bbox.x < border_width || bbox.y < border_width ||
-                                   bbox.x + bbox.width > img_gray.cols - border_width ||
-                                   bbox.y + bbox.height > img_gray.rows - border_width);
-                
-                if (!near_border || area > total_area * 0.3) {
-                    valid_contours.push_back(std::make_pair(area, i));
-                }
+    }
+    
+    int region_count = labelFootRegions(workspace, img_thresh);
+    if (region_count <= 1) {
+        LOGE("Aucun contour détecté");
+        return false;
+    }
+    
+    // Plus grande région (aire déjà calculée par l'étiquetage), seule tracée
+    int largest_label = 1;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_FILTER);
+        const cv::Mat& stats = workspace.component_stats;
+        for (int label = 2; label < region_count; label++) {
+            if (stats.at<int>(label, cv::CC_STAT_AREA) > stats.at<int>(largest_label, cv::CC_STAT_AREA)) {
+                largest_label = label;
             }
         }
-        
-        std::sort(valid_contours.begin(), valid_contours.end(), 
-                  [](const auto& a, const auto& b) { return a.first > b.first; });
-
-        if (valid_contours.empty()) {
-            *outSize = 0;
-            return nullptr;
-        }
-
-        cv::Mat mask = cv::Mat::zeros(img_gray.size(), CV_8UC1);
-        size_t num_contours = std::min(size_t(2), valid_contours.size());
-        
-        for (size_t i = 0; i < num_contours; i++) {
-            size_t idx = valid_contours[i].second;
-            cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{contours[idx]}, cv::Scalar(255));
-        }
+    }
+    if (!traceFootRegion(workspace, largest_label)) {
+        LOGE("Aucun contour détecté");
+        return false;
+    }
+    
+    StageTimer timer(workspace, FOOT_STAGE_MEASURE);
+    FootMeasurements foot_measurements = analyzeFootShapeAdaptive(workspace.contours[0], calibration, img_bgr.size());
+    fillMeasurementResult(foot_measurements, calibration, img_bgr.size(), out);
+    
+    LOGI("✅ Extraction réussie");
+    return true;
+}
 
-        cv::Mat result;
-        cv::Scalar bg_color = (background_intensity > 128) ? cv::Scalar(255, 255, 255) : cv::Scalar(0, 0, 0);
-        
-        cv::Mat colored_bg = cv::Mat::ones(img_bgr.size(), img_bgr.type());
-        colored_bg = colored_bg.mul(cv::Scalar(bg_color[0], bg_color[1], bg_color[2]));
-        
-        img_bgr.copyTo(colored_bg, mask);
-        result = colored_bg;
+// Contours Canny d'une image décodée
+uint8_t* computeCannyEdges(const cv::Mat& image, FootEncodeOptions* options, int* outSize, void** outHandle) {
+    cv::Mat gray, edges;
+    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    cv::Canny(gray, edges, 100, 200);
+    
+    return encodeResultImage(edges, options, outSize, outHandle);
+}
 
-        for (size_t i = 0; i < num_contours; i++) {
-            size_t idx = valid_contours[i].second;
-            cv::drawContours(result, contours, idx, cv::Scalar(255, 0, 0), 3);
-            
-            ExtremePoints extremes = getExtremePoints(contours[idx]);
-            cv::circle(result, extremes.left, 8, cv::Scalar(255, 50, 0), -1);
-            cv::circle(result, extremes.right, 8, cv::Scalar(255, 255, 0), -1);
-            cv::circle(result, extremes.top, 8, cv::Scalar(0, 50, 255), -1);
-            cv::circle(result, extremes.bottom, 8, cv::Scalar(0, 255, 255), -1);
-        }
+// Régions retenues sur un fond uni (blanc si fond clair, noir sinon), contours et points extrêmes
+void composeForeground(const cv::Mat& img_bgr, const std::vector<std::vector<cv::Point>>& contours,
+                       bool light_background, cv::Mat& result) {
+    cv::Mat mask = cv::Mat::zeros(img_bgr.size(), CV_8UC1);
+    for (const auto& contour : contours) {
+        if (contour.empty()) continue;
+        cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{contour}, cv::Scalar(255));
+    }
 
-        std::vector<uchar> buf;
-        cv::imencode(".png", result, buf);
-        *outSize = static_cast<int>(buf.size());
+    cv::Scalar bg_color = light_background ? cv::Scalar(255, 255, 255) : cv::Scalar(0, 0, 0);
+    result.create(img_bgr.size(), img_bgr.type());
+    result.setTo(bg_color);
+    img_bgr.copyTo(result, mask);
 
-        uint8_t* result_ptr = new uint8_t[*outSize];
-        std::memcpy(result_ptr, buf.data(), *outSize);
-        
-        return result_ptr;
-    } catch (const std::exception& e) {
-        LOGE("Exception removeBackground: %s", e.what());
-        *outSize = 0;
-        return nullptr;
+    for (size_t i = 0; i < contours.size(); i++) {
+        if (contours[i].empty()) continue;
+        cv::drawContours(result, contours, static_cast<int>(i), cv::Scalar(255, 0, 0), 3);
+        
+        ExtremePoints extremes = getExtremePoints(contours[i]);
+        cv::circle(result, extremes.left, 8, cv::Scalar(255, 50, 0), -1);
+        cv::circle(result, extremes.right, 8, cv::Scalar(255, 255, 0), -1);
+        cv::circle(result, extremes.top, 8, cv::Scalar(0, 50, 255), -1);
+        cv::circle(result, extremes.bottom, 8, cv::Scalar(0, 255, 255), -1);
     }
 }
 
-__attribute__((visibility("default")))
+// Contours des deux plus grandes régions de premier plan (paramètres fixes de la suppression
+// d'arrière-plan, indépendants de la segmentation adaptative du pied). Faux si aucune région.
+// Entrée: niveaux de gris floutés 5x5 et leur seuil d'Otsu, les mêmes que ceux de la
+// segmentation du pied; bord (1/10), noyau 5x5 et filtre d'aire restent propres à ce masque.
+bool findForegroundContours(const cv::Mat& img_blurred, double otsu_threshold,
+                            std::vector<std::vector<cv::Point>>& contours, bool* light_background) {
+    cv::Mat border_mask = cv::Mat::zeros(img_blurred.size(), CV_8UC1);
+    int border_width = std::min(img_blurred.rows, img_blurred.cols) / 10;
+    
+    cv::rectangle(border_mask, cv::Point(0, 0), cv::Point(img_blurred.cols, border_width), cv::Scalar(255), -1);
+    cv::rectangle(border_mask, cv::Point(0, img_blurred.rows - border_width), cv::Point(img_blurred.cols, img_blurred.rows), cv::Scalar(255), -1);
+    cv::rectangle(border_mask, cv::Point(0, 0), cv::Point(border_width, img_blurred.rows), cv::Scalar(255), -1);
+    cv::rectangle(border_mask, cv::Point(img_blurred.cols - border_width, 0), cv::Point(img_blurred.cols, img_blurred.rows), cv::Scalar(255), -1);
+    
+    cv::Scalar border_mean = cv::mean(img_blurred, border_mask);
+    double background_intensity = border_mean[0];
+    
+    cv::Mat img_thresh;
+    int threshold_type = cv::THRESH_BINARY;
+    if (background_intensity > 128 && otsu_threshold > background_intensity * 0.7) {
+        threshold_type = cv::THRESH_BINARY_INV;
+    }
+    cv::threshold(img_blurred, img_thresh, otsu_threshold, 255, threshold_type);
+    
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(img_thresh, img_thresh, cv::MORPH_OPEN, kernel);
+    
+    // Régions en une passe; seules les régions retenues sont tracées
+    cv::Mat labels, stats, centroids;
+    int region_count = cv::connectedComponentsWithStats(img_thresh, labels, stats, centroids, 8, CV_32S, cv::CCL_DEFAULT);
+    
+    if (region_count <= 1) return false;
+
+    std::vector<std::pair<double, int>> valid_contours;
+    double total_area = img_blurred.rows * img_blurred.cols;
+    
+    for (int i = 1; i < region_count; i++) {
+        double area = stats.at<int>(i, cv::CC_STAT_AREA);
+        if (area > total_area * 0.01 && area < total_area * 0.8) {
+            cv::Rect bbox = regionBoundingBox(stats, i);
+            bool near_border = (bbox.x < border_width || bbox.y < border_width ||
+                               bbox.x + bbox.width > img_blurred.cols - border_width ||
+                               bbox.y + bbox.height > img_blurred.rows - border_width);
+            
+            if (!near_border || area > total_area * 0.3) {
+                valid_contours.push_back(std::make_pair(area, i));
+            }
+        }
+    }
+    
+    std::sort(valid_contours.begin(), valid_contours.end(), 
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    if (valid_contours.empty()) return false;
+
+    size_t num_contours = std::min(size_t(2), valid_contours.size());
+    contours.assign(num_contours, std::vector<cv::Point>());
+    cv::Mat region_mask;
+    for (size_t i = 0; i < num_contours; i++) {
+        traceRegionContour(labels, stats, valid_contours[i].second, region_mask, contours[i]);
+    }
+    *light_background = background_intensity > 128;
+    return true;
+}
+
+// Suppression d'arrière-plan sur une image décodée
+uint8_t* removeBackgroundFromImage(const cv::Mat& img_bgr, FootEncodeOptions* options, int* outSize, void** outHandle) {
+    cv::Mat img_gray, img_blurred, img_thresh;
+    cv::cvtColor(img_bgr, img_gray, cv::COLOR_BGR2GRAY);
+    cv::GaussianBlur(img_gray, img_blurred, cv::Size(5, 5), 0);
+    double otsu_threshold = cv::threshold(img_blurred, img_thresh, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+    
+    std::vector<std::vector<cv::Point>> contours;
+    bool light_background = false;
+    if (!findForegroundContours(img_blurred, otsu_threshold, contours, &light_background)) {
+        *outSize = 0;
+        return nullptr;
+    }
+    
+    cv::Mat result;
+    composeForeground(img_bgr, contours, light_background, result);
+    return encodeResultImage(result, options, outSize, outHandle);
+}
+
+// FONCTION D'EXTRACTION DE MESURES (legacy)
+// Retourne [length, width, heel_to_arch, arch_to_toe, big_toe, is_calibrated], à libérer avec freeMeasurements.
+// Préférer extractFootMeasurementsBuffer et FootMeasurementResult.
+__attribute__((visibility("default")))
+double* extractFootMeasurements(const char* path, double qr_size_cm) {
+    LOGI("🔍 extractFootMeasurements (QR: %.1f cm)", qr_size_cm);
+    
+    double* measurements = new double[6];
+    for (int i = 0; i < 6; i++) measurements[i] = 0.0;
+    
+    try {
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, nullptr);
+        cv::Mat img_bgr = loadImageWith(workspace, path);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
+            return measurements;
+        }
+        
+        FootMeasurementResult result;
+        result.struct_size = sizeof(FootMeasurementResult);
+        resetMeasurementResult(&result);
+        extractMeasurementsFromImage(workspace, img_bgr, qr_size_cm, &result);
+        
+        measurements[0] = result.length_cm;
+        measurements[1] = result.width_cm;
+        measurements[2] = result.heel_to_arch_cm;
+        measurements[3] = result.arch_to_toe_cm;
+        measurements[4] = result.big_toe_length_cm;
+        measurements[5] = result.is_calibrated ? 1.0 : 0.0;
+        return measurements;
+    } catch (const std::exception& e) {
+        LOGE("Exception extractFootMeasurements: %s", e.what());
+        return measurements;
+    }
+}
+
+// FONCTIONS EXISTANTES (inchangées)
+__attribute__((visibility("default")))
+uint8_t* processImage(const char* path, int* outSize) {
+    LOGI("processImage appelée");
+    
+    if (path == nullptr || outSize == nullptr) {
+        LOGE("Paramètres invalides");
+        *outSize = 0;
+        return nullptr;
+    }
+    
+    try {
+        cv::Mat image = cv::imread(path, cv::IMREAD_COLOR);
+        if (image.empty()) {
+            LOGE("Impossible de charger l'image: %s", path);
+            *outSize = 0;
+            return nullptr;
+        }
+        
+        return computeCannyEdges(image, nullptr, outSize, nullptr);
+    } catch (const std::exception& e) {
+        LOGE("Exception processImage: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+__attribute__((visibility("default")))
+uint8_t* removeBackground(const char* path, int* outSize) {
+    LOGI("removeBackground appelée");
+    
+    if (path == nullptr || outSize == nullptr) {
+        LOGE("Paramètres invalides");
+        *outSize = 0;
+        return nullptr;
+    }
+    
+    try {
+        cv::Mat img_bgr = cv::imread(path, cv::IMREAD_COLOR);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
+            *outSize = 0;
+            return nullptr;
+        }
+        
+        return removeBackgroundFromImage(img_bgr, nullptr, outSize, nullptr);
+    } catch (const std::exception& e) {
+        LOGE("Exception removeBackground: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+// ============================================================================
+// API MÉMOIRE: variantes prenant les octets encodés (JPEG/PNG) en entrée
+// Aucune écriture de fichier temporaire, décodage direct via cv::imdecode.
+// ============================================================================
+
+// Les variantes *Buffer acceptent un outHandle optionnel (voir encodeResultImageWith):
+// s'il est fourni, le résultat n'est pas copié et se libère avec releaseImageBuffer.
+// options (FootEncodeOptions, optionnel): format, qualité et taille maximale de l'image
+// résultat; nul pour le PNG pleine résolution.
+
+// Décodage d'un tampon encodé sans copie préalable des octets
+cv::Mat decodeImageBuffer(const uint8_t* data, int length, int flags) {
+    if (data == nullptr || length <= 0) {
+        return cv::Mat();
+    }
+    cv::Mat raw(1, length, CV_8UC1, const_cast<uint8_t*>(data));
+    return cv::imdecode(raw, flags);
+}
+
+// Décodage chronométré
+cv::Mat decodeImageBufferWith(PipelineWorkspace& workspace, const uint8_t* data, int length) {
+    StageTimer timer(workspace, FOOT_STAGE_DECODE);
+    return decodeImageBuffer(data, length, cv::IMREAD_COLOR);
+}
+
+__attribute__((visibility("default")))
+uint8_t* measureFootWithQRBuffer(const uint8_t* data, int length, int* outSize, double qr_size_cm, void** outHandle,
+                                 FootEncodeOptions* options) {
+    LOGI("🔍 measureFootWithQRBuffer (%d octets, QR: %.1f cm)", length, qr_size_cm);
+    
+    if (outSize == nullptr || !validEncodeOptions(options)) {
+        LOGE("Paramètres invalides");
+        return nullptr;
+    }
+    *outSize = 0;
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    try {
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, nullptr);
+        cv::Mat img_bgr = decodeImageBufferWith(workspace, data, length);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
+            return nullptr;
+        }
+        
+        return runFootMeasurementPipeline(workspace, img_bgr, qr_size_cm, options, outSize, outHandle, nullptr);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception measureFootWithQRBuffer: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+__attribute__((visibility("default")))
+uint8_t* processFootWithQRBuffer(const uint8_t* data, int length, int* outSize,
+                                 double qr_size_cm, FootMeasurementResult* outResult, void** outHandle,
+                                 FootEncodeOptions* options) {
+    LOGI("🚀 processFootWithQRBuffer (%d octets, QR: %.1f cm)", length, qr_size_cm);
+    
+    if (outSize == nullptr || !validEncodeOptions(options) || !resetMeasurementResult(outResult)) {
+        LOGE("Paramètres invalides");
+        if (outSize != nullptr) *outSize = 0;
+        return nullptr;
+    }
+    
+    *outSize = 0;
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    try {
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, outResult);
+        cv::Mat img_bgr = decodeImageBufferWith(workspace, data, length);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
+            return nullptr;
+        }
+        
+        return runFootMeasurementPipeline(workspace, img_bgr, qr_size_cm, options, outSize, outHandle, outResult);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception processFootWithQRBuffer: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+// outResult: FootMeasurementResult fourni par l'appelant. Retourne 1 si un contour a été mesuré.
+__attribute__((visibility("default")))
+int extractFootMeasurementsBuffer(const uint8_t* data, int length, double qr_size_cm, FootMeasurementResult* outResult) {
+    LOGI("🔍 extractFootMeasurementsBuffer (%d octets, QR: %.1f cm)", length, qr_size_cm);
+    
+    if (!resetMeasurementResult(outResult)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    try {
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, outResult);
+        cv::Mat img_bgr = decodeImageBufferWith(workspace, data, length);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
+            return 0;
+        }
+        
+        return extractMeasurementsFromImage(workspace, img_bgr, qr_size_cm, outResult) ? 1 : 0;
+    } catch (const std::exception& e) {
+        LOGE("Exception extractFootMeasurementsBuffer: %s", e.what());
+        return 0;
+    }
+}
+
+__attribute__((visibility("default")))
+uint8_t* processImageBuffer(const uint8_t* data, int length, int* outSize, void** outHandle,
+                            FootEncodeOptions* options) {
+    LOGI("processImageBuffer appelée");
+    
+    if (outSize == nullptr || !validEncodeOptions(options)) {
+        LOGE("Paramètres invalides");
+        return nullptr;
+    }
+    *outSize = 0;
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    try {
+        cv::Mat image = decodeImageBuffer(data, length, cv::IMREAD_COLOR);
+        if (image.empty()) {
+            LOGE("Image vide");
+            return nullptr;
+        }
+        
+        return computeCannyEdges(image, options, outSize, outHandle);
+    } catch (const std::exception& e) {
+        LOGE("Exception processImageBuffer: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+__attribute__((visibility("default")))
+uint8_t* removeBackgroundBuffer(const uint8_t* data, int length, int* outSize, void** outHandle,
+                                FootEncodeOptions* options) {
+    LOGI("removeBackgroundBuffer appelée");
+    
+    if (outSize == nullptr || !validEncodeOptions(options)) {
+        LOGE("Paramètres invalides");
+        return nullptr;
+    }
+    *outSize = 0;
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    try {
+        cv::Mat img_bgr = decodeImageBuffer(data, length, cv::IMREAD_COLOR);
+        if (img_bgr.empty()) {
+            LOGE("Image vide");
+            return nullptr;
+        }
+        
+        return removeBackgroundFromImage(img_bgr, options, outSize, outHandle);
+    } catch (const std::exception& e) {
+        LOGE("Exception removeBackgroundBuffer: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+// ============================================================================
+// SESSION DE MESURE: images de travail, noyau et détecteur QR conservés entre captures
+// (pas de réallocation des tampons à la taille de l'image; voir PipelineWorkspace)
+// ============================================================================
+
+// width/height: résolution attendue pour la préallocation (0 = au premier appel)
+__attribute__((visibility("default")))
+void* createMeasurementSession(int width, int height) {
+    LOGI("🧰 createMeasurementSession (%dx%d)", width, height);
+    try {
+        PipelineWorkspace* workspace = new PipelineWorkspace();
+        if (width > 0 && height > 0) {
+            workspace->reserve(cv::Size(width, height));
+        }
+        return workspace;
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception createMeasurementSession: %s", e.what());
+        return nullptr;
+    }
+}
+
+// Pipeline fusionné sur les tampons de la session.
+// outImage/outSize nuls: mesures seules, sans annotation ni encodage.
+// outImage reçoit l'image (PNG, ou selon options) à libérer avec freeMemory, ou avec
+// releaseImageBuffer(*outHandle) si outHandle est fourni (cession sans copie du tampon de la session).
+// outResult: FootMeasurementResult fourni par l'appelant. Retourne 1 si un pied a été mesuré.
+__attribute__((visibility("default")))
+int sessionProcessFoot(void* session, const uint8_t* data, int length, double qr_size_cm,
+                       FootMeasurementResult* outResult, uint8_t** outImage, int* outSize, void** outHandle,
+                       FootEncodeOptions* options) {
+    if (session == nullptr || (outImage == nullptr) != (outSize == nullptr) || !validEncodeOptions(options) ||
+        !resetMeasurementResult(outResult)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    if (outImage != nullptr) {
+        *outImage = nullptr;
+        *outSize = 0;
+    }
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    PipelineWorkspace& workspace = *static_cast<PipelineWorkspace*>(session);
+    CallTimer call_timer(workspace, outResult);
+    try {
+        if (data == nullptr || length <= 0) {
+            LOGE("Image vide");
+            return 0;
+        }
+        
+        // Décodage dans le tampon de la session (réutilisé si la taille est inchangée)
+        {
+            StageTimer timer(workspace, FOOT_STAGE_DECODE);
+            cv::Mat raw(1, length, CV_8UC1, const_cast<uint8_t*>(data));
+            cv::imdecode(raw, cv::IMREAD_COLOR, &workspace.img_bgr);
+        }
+        if (workspace.img_bgr.empty()) {
+            LOGE("Image vide");
+            return 0;
+        }
+        
+        if (outImage != nullptr) {
+            *outImage = runFootMeasurementPipeline(workspace, workspace.img_bgr, qr_size_cm, options,
+                                                   outSize, outHandle, outResult);
+            return *outImage != nullptr ? 1 : 0;
+        }
+        
+        {
+            StageTimer timer(workspace, FOOT_STAGE_GRAY);
+            cv::cvtColor(workspace.img_bgr, workspace.img_gray, cv::COLOR_BGR2GRAY);
+        }
+        RobustCalibrationData calibration;
+        size_t best_contour_idx = 0;
+        FootMeasurements foot_measurements;
+        if (!analyzeFootFromGray(workspace, workspace.img_gray, qr_size_cm, calibration,
+                                 best_contour_idx, foot_measurements)) {
+            fillCalibrationResult(calibration, outResult);
+            return 0;
+        }
+        
+        fillMeasurementResult(foot_measurements, calibration, workspace.img_gray.size(), outResult);
+        return 1;
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception sessionProcessFoot: %s", e.what());
+        return 0;
+    }
+}
+
+__attribute__((visibility("default")))
+void destroyMeasurementSession(void* session) {
+    delete static_cast<PipelineWorkspace*>(session);
+}
+
+// ============================================================================
+// SUPERPOSITION VECTORIELLE: contour, points clés et QR rendus côté Flutter
+// L'image d'origine n'est ni copiée, ni annotée, ni réencodée: décodage en
+// niveaux de gris seulement, sommets en pixels de l'image décodée.
+// ============================================================================
+
+// Remise à zéro d'un FootOverlay fourni par l'appelant
+bool resetFootOverlay(FootOverlay* out) {
+    if (out == nullptr) return false;
+    if (out->struct_size < sizeof(FootOverlay)) {
+        LOGE("❌ FootOverlay trop petit: %u < %u octets",
+             out->struct_size, static_cast<unsigned>(sizeof(FootOverlay)));
+        return false;
+    }
+    
+    uint32_t struct_size = out->struct_size;
+    std::memset(out, 0, sizeof(FootOverlay));
+    out->struct_size = struct_size;
+    out->version = FOOT_OVERLAY_VERSION;
+    return true;
+}
+
+void fillOverlayQuad(const RobustCalibrationData& calibration, FootOverlay* out) {
+    if (calibration.qr_quad.size() != 4) return;
+    out->has_qr_quad = 1;
+    for (int i = 0; i < 4; i++) {
+        out->qr_quad_xy[2 * i] = calibration.qr_quad[i].x;
+        out->qr_quad_xy[2 * i + 1] = calibration.qr_quad[i].y;
+    }
+}
+
+// Polyligne du pied réduite à FOOT_OVERLAY_MAX_POINTS sommets (Douglas-Peucker, tolérance doublée
+// jusqu'à tenir), plus les points clés
+void fillFootOverlay(PipelineWorkspace& workspace, const std::vector<cv::Point>& contour,
+                     const FootMeasurements& foot_measurements, FootOverlay* out) {
+    const std::vector<cv::Point>* vertices = &contour;
+    if (contour.size() > FOOT_OVERLAY_MAX_POINTS) {
+        std::vector<cv::Point>& simplified = workspace.overlay_contour;
+        double epsilon = 1.0;
+        do {
+            cv::approxPolyDP(contour, simplified, epsilon, true);
+            epsilon *= 2.0;
+        } while (simplified.size() > FOOT_OVERLAY_MAX_POINTS);
+        vertices = &simplified;
+    }
+    
+    out->contour_point_count = static_cast<int32_t>(vertices->size());
+    for (size_t i = 0; i < vertices->size(); i++) {
+        out->contour_xy[2 * i] = static_cast<float>((*vertices)[i].x);
+        out->contour_xy[2 * i + 1] = static_cast<float>((*vertices)[i].y);
+    }
+    
+    const cv::Point2f keypoints[4] = {
+        foot_measurements.heel_point, foot_measurements.toe_point,
+        foot_measurements.left_point, foot_measurements.right_point,
+    };
+    for (int i = 0; i < 4; i++) {
+        out->keypoints_xy[2 * i] = keypoints[i].x;
+        out->keypoints_xy[2 * i + 1] = keypoints[i].y;
+    }
+}
+
+// Mesures + superposition dans le workspace (paramètres déjà validés)
+int measureFootOverlayWith(PipelineWorkspace& workspace, const uint8_t* data, int length, double qr_size_cm,
+                           FootMeasurementResult* outResult, FootOverlay* outOverlay) {
+    CallTimer call_timer(workspace, outResult);
+    if (data == nullptr || length <= 0) {
+        LOGE("Image vide");
+        return 0;
+    }
+    
+    // Niveaux de gris directement: ni BGR, ni conversion
+    cv::Mat& img_gray = workspace.img_gray;
+    {
+        StageTimer timer(workspace, FOOT_STAGE_DECODE);
+        cv::Mat raw(1, length, CV_8UC1, const_cast<uint8_t*>(data));
+        cv::imdecode(raw, cv::IMREAD_GRAYSCALE, &img_gray);
+    }
+    if (img_gray.empty()) {
+        LOGE("Image vide");
+        return 0;
+    }
+    outOverlay->image_width = img_gray.cols;
+    outOverlay->image_height = img_gray.rows;
+    
+    RobustCalibrationData calibration;
+    size_t best_contour_idx = 0;
+    FootMeasurements foot_measurements;
+    bool found = analyzeFootFromGray(workspace, img_gray, qr_size_cm, calibration, best_contour_idx, foot_measurements);
+    fillOverlayQuad(calibration, outOverlay);
+    if (!found) {
+        fillCalibrationResult(calibration, outResult);
+        return 0;
+    }
+    
+    StageTimer timer(workspace, FOOT_STAGE_DRAW);
+    fillMeasurementResult(foot_measurements, calibration, img_gray.size(), outResult);
+    fillFootOverlay(workspace, workspace.contours[best_contour_idx], foot_measurements, outOverlay);
+    return 1;
+}
+
+// outResult/outOverlay: structures fournies par l'appelant. Retourne 1 si un pied a été mesuré
+// (outOverlay porte alors le contour; le quadrilatère QR est rempli dès que le QR est détecté).
+__attribute__((visibility("default")))
+int measureFootOverlayBuffer(const uint8_t* data, int length, double qr_size_cm,
+                             FootMeasurementResult* outResult, FootOverlay* outOverlay) {
+    LOGI("🖊️ measureFootOverlayBuffer (%d octets, QR: %.1f cm)", length, qr_size_cm);
+    
+    if (!resetMeasurementResult(outResult) || !resetFootOverlay(outOverlay)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    try {
+        PipelineWorkspace workspace;
+        return measureFootOverlayWith(workspace, data, length, qr_size_cm, outResult, outOverlay);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception measureFootOverlayBuffer: %s", e.what());
+        return 0;
+    }
+}
+
+// Variante sur les tampons d'une session de mesure
+__attribute__((visibility("default")))
+int sessionMeasureFootOverlay(void* session, const uint8_t* data, int length, double qr_size_cm,
+                              FootMeasurementResult* outResult, FootOverlay* outOverlay) {
+    if (session == nullptr || !resetMeasurementResult(outResult) || !resetFootOverlay(outOverlay)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    try {
+        return measureFootOverlayWith(*static_cast<PipelineWorkspace*>(session), data, length, qr_size_cm,
+                                      outResult, outOverlay);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception sessionMeasureFootOverlay: %s", e.what());
+        return 0;
+    }
+}
+
+// ============================================================================
+// IMAGE ANALYSÉE: graphe de nœuds nommés, résultats mémorisés par image
+// Chaque sortie (mesures, image annotée, fond supprimé, masque, contours Canny)
+// ne calcule que les nœuds qui lui manquent:
+//   (image) -> gray -> reduced -+-> qr -> calibration(qr_size_cm) ----------+
+//                 |             +-> regions (masque, étiquetage) -> foot ---+-> measurements(qr_size_cm)
+//                 +-> blurred (flou 5x5, seuil d'Otsu) -> foreground
+//                 +-> edges
+// qr (ROI du QR), foot et measurements (affinage des points extrêmes) lisent aussi gray.
+// blurred reprend le flou et le seuil de regions quand la segmentation est pleine résolution;
+// foreground (fond supprimé) garde ses propres bord, noyau et filtre d'aire, donc son masque.
+// Un seul décodage par image: gray directement en niveaux de gris (ou par conversion de la
+// couleur déjà décodée), reduced par réduction de gray; la couleur (image) n'est décodée que
+// pour les sorties qui la dessinent.
+// ============================================================================
+
+enum FootGraphNode {
+    GRAPH_IMAGE = 0,    // décodage BGR
+    GRAPH_GRAY,         // niveaux de gris pleine résolution
+    GRAPH_REDUCED,      // niveaux de gris réduits 1/2 à 1/8 (recherche QR, segmentation grossière)
+    GRAPH_QR,           // détection et décodage du QR (sans sa taille réelle)
+    GRAPH_REGIONS,      // masque adaptatif, étiquetage et régions candidates
+    GRAPH_FOOT,         // contour de la région retenue, pleine résolution
+    GRAPH_EDGES,        // contours Canny
+    GRAPH_BLURRED,      // flou 5x5 pleine résolution et seuil d'Otsu
+    GRAPH_FOREGROUND,   // deux plus grandes régions de premier plan (suppression d'arrière-plan)
+    GRAPH_NODE_COUNT
+};
+
+const char* const kGraphNodeNames[GRAPH_NODE_COUNT] = {
+    "image", "gray", "reduced", "qr", "regions", "foot", "edges", "blurred", "foreground"
+};
+
+// Nœuds calculés à la demande, au plus une fois; calibration et mesures mémorisées pour la
+// dernière taille de QR demandée. Tampons dans le workspace de l'image.
+class FootImageGraph {
+public:
+    FootImageGraph(const uint8_t* data, int length) : encoded_(data, data + length) {}
+    
+    std::mutex& mutex() { return mutex_; }
+    PipelineWorkspace& workspace() { return workspace_; }
+    
+    const cv::Mat* image() {
+        return run(GRAPH_IMAGE, &FootImageGraph::computeImage) ? &workspace_.img_bgr : nullptr;
+    }
+    
+    const cv::Mat* gray() {
+        return run(GRAPH_GRAY, &FootImageGraph::computeGray) ? &workspace_.img_gray : nullptr;
+    }
+    
+    // Nul si l'image est trop petite pour une étape grossière
+    const cv::Mat* reduced() {
+        return run(GRAPH_REDUCED, &FootImageGraph::computeReduced) ? &reduced_ : nullptr;
+    }
+    
+    // Calculé même sans QR dans l'image (found = false)
+    const QRDetection* qr() {
+        return run(GRAPH_QR, &FootImageGraph::computeQR) ? &qr_ : nullptr;
+    }
+    
+    const RobustCalibrationData* calibration(double qr_size_cm) {
+        const QRDetection* detection = qr();
+        if (detection == nullptr) return nullptr;
+        if (!has_calibration_ || calibration_qr_size_ != qr_size_cm) {
+            calibration_ = calibrateFromQR(*detection, qr_size_cm);
+            calibration_qr_size_ = qr_size_cm;
+            has_calibration_ = true;
+            has_measurements_ = false;
+        }
+        return &calibration_;
+    }
+    
+    bool regions() {
+        return run(GRAPH_REGIONS, &FootImageGraph::computeRegions);
+    }
+    
+    // Contour d'une région candidate en pixels pleine résolution
+    bool traceCandidate(int label, std::vector<cv::Point>& contour) {
+        if (!traceRegionContour(workspace_.component_labels, workspace_.component_stats, label,
+                                workspace_.component_mask, contour)) {
+            return false;
+        }
+        if (coarse_) {
+            const cv::Mat* img_gray = gray();
+            if (img_gray == nullptr) return false;
+            scaleCoarseContour(contour, region_size_, img_gray->size());
+        }
+        return true;
+    }
+    
+    const std::vector<cv::Point>* foot() {
+        return run(GRAPH_FOOT, &FootImageGraph::computeFoot) ? &foot_contours_[0] : nullptr;
+    }
+    
+    // { contour du pied }, pour drawFootAnnotations; valide après foot()
+    const std::vector<std::vector<cv::Point>>& footContours() const { return foot_contours_; }
+    
+    // Nul si aucun pied (la calibration reste disponible)
+    const FootMeasurements* measurements(double qr_size_cm) {
+        const RobustCalibrationData* calibration_data = calibration(qr_size_cm);
+        if (calibration_data == nullptr || foot() == nullptr) return nullptr;
+        if (!has_measurements_) {
+            double coarse_scale = coarse_ ? static_cast<double>(workspace_.img_gray.cols) / region_size_.width : 1.0;
+            measurements_ = measureFootContour(workspace_, workspace_.img_gray, foot_contours_[0],
+                                               coarse_scale, *calibration_data);
+            has_measurements_ = true;
+        }
+        return &measurements_;
+    }
+    
+    const cv::Mat* edges() {
+        return run(GRAPH_EDGES, &FootImageGraph::computeEdges) ? &edges_ : nullptr;
+    }
+    
+    // Niveaux de gris floutés 5x5; seuil d'Otsu dans blurredThreshold()
+    const cv::Mat* blurred() {
+        return run(GRAPH_BLURRED, &FootImageGraph::computeBlurred) ? &blurred_ : nullptr;
+    }
+    
+    double blurredThreshold() const { return blurred_threshold_; }
+    
+    // Contours de premier plan pour composeForeground; fond clair dans lightBackground()
+    const std::vector<std::vector<cv::Point>>* foreground() {
+        return run(GRAPH_FOREGROUND, &FootImageGraph::computeForeground) ? &foreground_contours_ : nullptr;
+    }
+    
+    bool lightBackground() const { return light_background_; }
+    
+    // Mêmes octets encodés (vérification après égalité des empreintes)
+    bool matches(const uint8_t* data, int length) const {
+        return encoded_.size() == static_cast<size_t>(length) &&
+               std::memcmp(encoded_.data(), data, encoded_.size()) == 0;
+    }
+    
+    // Libère les tampons de travail qui ne portent aucun nœud (réalloués si besoin)
+    void releaseScratch() {
+        workspace_.img_blurred.release();
+        workspace_.img_thresh.release();
+        workspace_.img_coarse.release();
+        workspace_.result.release();
+        workspace_.straight_qrcode.release();
+        workspace_.qr_coarse.release();
+        workspace_.component_mask.release();
+        workspace_.refine_blurred.release();
+        workspace_.refine_mask.release();
+        workspace_.edge_strip.release();
+        workspace_.edge_profile.release();
+        std::vector<uchar>().swap(workspace_.encode_buffer);
+        std::vector<std::vector<cv::Point>>().swap(workspace_.contours);
+    }
+    
+    // Libère la couleur, le flou et les contours Canny (redécodés / recalculés à la demande): une
+    // entrée en cache ne garde que les niveaux de gris et les résultats (QR, étiquettes, contours,
+    // mesures)
+    void releaseRedecodable() {
+        if (state_[GRAPH_IMAGE] == NODE_DONE) {
+            workspace_.img_bgr.release();
+            state_[GRAPH_IMAGE] = NODE_PENDING;
+        }
+        if (state_[GRAPH_EDGES] == NODE_DONE) {
+            edges_.release();
+            state_[GRAPH_EDGES] = NODE_PENDING;
+        }
+        if (state_[GRAPH_BLURRED] == NODE_DONE) {
+            blurred_.release();
+            state_[GRAPH_BLURRED] = NODE_PENDING;
+        }
+    }
+    
+    // Mémoire retenue par les nœuds calculés (octets)
+    size_t memoryBytes() const {
+        return encoded_.size() + matBytes(workspace_.img_bgr) + matBytes(workspace_.img_gray) +
+               matBytes(reduced_) + matBytes(workspace_.component_labels) + matBytes(edges_) +
+               matBytes(blurred_);
+    }
+    
+private:
+    static size_t matBytes(const cv::Mat& mat) { return mat.total() * mat.elemSize(); }
+    
+    enum NodeState { NODE_PENDING = 0, NODE_DONE, NODE_FAILED };
+    
+    bool run(FootGraphNode node, bool (FootImageGraph::*compute)()) {
+        if (state_[node] == NODE_PENDING) {
+            bool ok = (this->*compute)();
+            state_[node] = ok ? NODE_DONE : NODE_FAILED;
+            LOGD("🧩 Nœud %s: %s", kGraphNodeNames[node], ok ? "calculé" : "échec");
+        }
+        return state_[node] == NODE_DONE;
+    }
+    
+    bool computeImage() {
+        StageTimer timer(workspace_, FOOT_STAGE_DECODE);
+        cv::Mat raw(1, static_cast<int>(encoded_.size()), CV_8UC1, encoded_.data());
+        cv::imdecode(raw, cv::IMREAD_COLOR, &workspace_.img_bgr);
+        return !workspace_.img_bgr.empty();
+    }
+    
+    // Couleur déjà décodée: conversion; sinon décodage direct en niveaux de gris
+    bool computeGray() {
+        if (state_[GRAPH_IMAGE] == NODE_DONE) {
+            StageTimer timer(workspace_, FOOT_STAGE_GRAY);
+            cv::cvtColor(workspace_.img_bgr, workspace_.img_gray, cv::COLOR_BGR2GRAY);
+            return true;
+        }
+        StageTimer timer(workspace_, FOOT_STAGE_DECODE);
+        cv::Mat raw(1, static_cast<int>(encoded_.size()), CV_8UC1, encoded_.data());
+        cv::imdecode(raw, cv::IMREAD_GRAYSCALE, &workspace_.img_gray);
+        return !workspace_.img_gray.empty();
+    }
+    
+    // Réduction de gray plutôt qu'un décodage JPEG réduit (IMREAD_REDUCED_*): toutes les
+    // sorties lisent aussi gray, un second décodage entropique coûterait plus que la réduction
+    bool computeReduced() {
+        const cv::Mat* img_gray = gray();
+        if (img_gray == nullptr) return false;
+        reduced_factor_ = coarseReductionFactor(img_gray->size());
+        if (reduced_factor_ == 1) return false;
+        // Produit du décodage: compté avec lui
+        StageTimer timer(workspace_, FOOT_STAGE_DECODE);
+        cv::resize(*img_gray, reduced_,
+                   cv::Size(img_gray->cols / reduced_factor_, img_gray->rows / reduced_factor_),
+                   0, 0, cv::INTER_AREA);
+        return true;
+    }
+    
+    // Localisation sur l'image réduite, décodage sur la ROI pleine résolution
+    bool computeQR() {
+        const cv::Mat* img_reduced = reduced();
+        const cv::Mat* img_gray = gray();
+        if (img_gray == nullptr) return false;
+        qr_ = detectQRCodeWith(workspace_, *img_gray, img_reduced != nullptr ? *img_reduced : cv::Mat());
+        return true;
+    }
+    
+    // Grandes images: segmentation sur l'image réduite
+    bool computeRegions() {
+        const cv::Mat* img_reduced = reduced();
+        coarse_ = img_reduced != nullptr &&
+                  useCoarseSegmentation(cv::Size(img_reduced->cols * reduced_factor_,
+                                                 img_reduced->rows * reduced_factor_));
+        const cv::Mat* region_image = coarse_ ? img_reduced : gray();
+        if (region_image == nullptr) return false;
+        region_size_ = region_image->size();
+        region_params_.reset(new AdaptiveParams(region_size_));
+        return segmentFootRegions(workspace_, *region_image, *region_params_, best_label_);
+    }
+    
+    bool computeFoot() {
+        if (!regions()) return false;
+        StageTimer timer(workspace_, FOOT_STAGE_CONTOURS);
+        foot_contours_.resize(1);
+        return traceCandidate(best_label_, foot_contours_[0]);
+    }
+    
+    bool computeEdges() {
+        const cv::Mat* img_gray = gray();
+        if (img_gray == nullptr) return false;
+        cv::Canny(*img_gray, edges_, 100, 200);
+        return true;
+    }
+    
+    // Segmentation pleine résolution déjà faite: même flou et même seuil d'Otsu (preprocessFootMask
+    // et sa variante en bandes), repris du workspace; sinon (segmentation grossière) calculés ici
+    bool computeBlurred() {
+        const cv::Mat* img_gray = gray();
+        if (img_gray == nullptr) return false;
+        if (state_[GRAPH_REGIONS] != NODE_PENDING && !coarse_ &&
+            workspace_.img_blurred.size() == img_gray->size()) {
+            blurred_ = workspace_.img_blurred;
+            blurred_threshold_ = workspace_.mask_threshold;
+            return true;
+        }
+        {
+            StageTimer timer(workspace_, FOOT_STAGE_BLUR);
+            cv::GaussianBlur(*img_gray, blurred_, cv::Size(5, 5), 0);
+        }
+        StageTimer timer(workspace_, FOOT_STAGE_THRESHOLD);
+        blurred_threshold_ = cv::threshold(blurred_, workspace_.img_thresh, 0, 255,
+                                           cv::THRESH_BINARY | cv::THRESH_OTSU);
+        return true;
+    }
+    
+    bool computeForeground() {
+        const cv::Mat* img_blurred = blurred();
+        if (img_blurred == nullptr) return false;
+        return findForegroundContours(*img_blurred, blurred_threshold_, foreground_contours_, &light_background_);
+    }
+    
+    std::mutex mutex_;
+    std::vector<uint8_t> encoded_;
+    PipelineWorkspace workspace_;
+    NodeState state_[GRAPH_NODE_COUNT] = {};
+    
+    QRDetection qr_;
+    bool has_calibration_ = false;
+    double calibration_qr_size_ = 0.0;
+    RobustCalibrationData calibration_;
+    
+    cv::Mat reduced_;
+    int reduced_factor_ = 1;
+    bool coarse_ = false;
+    cv::Size region_size_;
+    std::unique_ptr<AdaptiveParams> region_params_;
+    int best_label_ = 0;
+    std::vector<std::vector<cv::Point>> foot_contours_;
+    
+    bool has_measurements_ = false;
+    FootMeasurements measurements_;
+    
+    cv::Mat edges_;
+    
+    cv::Mat blurred_;
+    double blurred_threshold_ = 0.0;
+    std::vector<std::vector<cv::Point>> foreground_contours_;
+    bool light_background_ = false;
+};
+
+// Dernière étape d'une sortie image (dessin ou composition), puis encodage
+uint8_t* renderFootImageOutput(FootImageGraph& graph, int output, double qr_size_cm,
+                               FootEncodeOptions* options, int* outSize, void** outHandle) {
+    PipelineWorkspace& workspace = graph.workspace();
+    const cv::Mat* rendered = nullptr;
+    cv::Mat mask;
+    
+    switch (output) {
+        case FOOT_OUTPUT_ANNOTATED: {
+            const cv::Mat* img_bgr = graph.image();
+            const FootMeasurements* foot_measurements = graph.measurements(qr_size_cm);
+            if (img_bgr == nullptr || foot_measurements == nullptr) return nullptr;
+            StageTimer timer(workspace, FOOT_STAGE_DRAW);
+            drawFootAnnotations(*img_bgr, graph.footContours(), 0, *graph.calibration(qr_size_cm),
+                                *foot_measurements, workspace.result);
+            rendered = &workspace.result;
+            break;
+        }
+        case FOOT_OUTPUT_BACKGROUND_REMOVED: {
+            // Mêmes paramètres que removeBackgroundFromImage, sur le flou du graphe
+            const cv::Mat* img_bgr = graph.image();
+            const std::vector<std::vector<cv::Point>>* contours = graph.foreground();
+            if (img_bgr == nullptr || contours == nullptr) return nullptr;
+            StageTimer timer(workspace, FOOT_STAGE_DRAW);
+            composeForeground(*img_bgr, *contours, graph.lightBackground(), workspace.result);
+            rendered = &workspace.result;
+            break;
+        }
+        case FOOT_OUTPUT_MASK: {
+            const cv::Mat* img_gray = graph.gray();
+            if (img_gray == nullptr || graph.foot() == nullptr) return nullptr;
+            StageTimer timer(workspace, FOOT_STAGE_DRAW);
+            mask = cv::Mat::zeros(img_gray->size(), CV_8UC1);
+            cv::fillPoly(mask, graph.footContours(), cv::Scalar(255));
+            rendered = &mask;
+            break;
+        }
+        case FOOT_OUTPUT_EDGES:
+            rendered = graph.edges();
+            break;
+        default:
+            LOGE("❌ Sortie inconnue: %d", output);
+            return nullptr;
+    }
+    if (rendered == nullptr) return nullptr;
+    
+    StageTimer timer(workspace, FOOT_STAGE_ENCODE);
+    return encodeResultImageWith(workspace.encode_buffer, *rendered, options, outSize, outHandle);
+}
+
+// Mesures puis image annotée (si outImage), mêmes conventions que sessionProcessFoot.
+// Retourne 1 si un pied a été mesuré (et l'image produite si demandée).
+int processFootImageWith(FootImageGraph& graph, double qr_size_cm, FootMeasurementResult* outResult,
+                         uint8_t** outImage, int* outSize, void** outHandle, FootEncodeOptions* options) {
+    if (outImage != nullptr) {
+        *outImage = nullptr;
+        *outSize = 0;
+    }
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    std::lock_guard<std::mutex> lock(graph.mutex());
+    CallTimer call_timer(graph.workspace(), outResult);
+    
+    // Image demandée: couleur décodée d'abord, niveaux de gris par conversion (un seul décodage)
+    if (outImage != nullptr && graph.image() == nullptr) {
+        LOGE("Image vide");
+        return 0;
+    }
+    
+    const RobustCalibrationData* calibration = graph.calibration(qr_size_cm);
+    if (calibration == nullptr) {
+        LOGE("Image vide");
+        return 0;
+    }
+    
+    const FootMeasurements* foot_measurements = graph.measurements(qr_size_cm);
+    if (foot_measurements == nullptr) {
+        fillCalibrationResult(*calibration, outResult);
+        return 0;
+    }
+    fillMeasurementResult(*foot_measurements, *calibration, graph.gray()->size(), outResult);
+    
+    if (outImage == nullptr) return 1;
+    *outImage = renderFootImageOutput(graph, FOOT_OUTPUT_ANNOTATED, qr_size_cm, options, outSize, outHandle);
+    return *outImage != nullptr ? 1 : 0;
+}
+
+// Mesures + superposition sur une image analysée, mêmes conventions que measureFootOverlayWith
+int measureFootImageOverlayWith(FootImageGraph& graph, double qr_size_cm, FootMeasurementResult* outResult,
+                                FootOverlay* outOverlay) {
+    std::lock_guard<std::mutex> lock(graph.mutex());
+    CallTimer call_timer(graph.workspace(), outResult);
+    
+    const RobustCalibrationData* calibration = graph.calibration(qr_size_cm);
+    if (calibration == nullptr) {
+        LOGE("Image vide");
+        return 0;
+    }
+    const cv::Size image_size = graph.gray()->size();
+    outOverlay->image_width = image_size.width;
+    outOverlay->image_height = image_size.height;
+    fillOverlayQuad(*calibration, outOverlay);
+    
+    const FootMeasurements* foot_measurements = graph.measurements(qr_size_cm);
+    if (foot_measurements == nullptr) {
+        fillCalibrationResult(*calibration, outResult);
+        return 0;
+    }
+    
+    StageTimer timer(graph.workspace(), FOOT_STAGE_DRAW);
+    fillMeasurementResult(*foot_measurements, *calibration, image_size, outResult);
+    fillFootOverlay(graph.workspace(), *graph.foot(), *foot_measurements, outOverlay);
+    return 1;
+}
+
+// ============================================================================
+// CACHE D'IMAGES ANALYSÉES: LRU borné, indexé par une empreinte du contenu encodé
+// Une capture rouverte ou relancée avec une autre taille de QR retrouve ses niveaux
+// de gris, son QR, ses régions et son contour: seuls calibration et mesures (qui
+// dépendent de qr_size_cm) puis dessin et encodage sont recalculés. La couleur est
+// libérée à la fin de chaque utilisation (~20 Mo retenus pour 12 MP, au lieu de ~50).
+// Vidage explicite sur pression mémoire: clearFootImageCache.
+// ============================================================================
+
+const size_t kFootImageCacheMaxEntries = 2;
+const size_t kFootImageCacheMaxBytes = size_t(48) << 20;
+
+// Empreinte rapide des octets encodés: FNV-1a sur des mots de 64 bits
+uint64_t contentHash(const uint8_t* data, size_t length) {
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL ^ length;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash ^ (hash >> 29);
+}
+
+class FootImageCache {
+public:
+    // Image analysée de ces octets: entrée existante (remise en tête) ou nouvelle entrée
+    std::shared_ptr<FootImageGraph> acquire(const uint8_t* data, int length) {
+        uint64_t hash = contentHash(data, static_cast<size_t>(length));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::shared_ptr<FootImageGraph> cached = findLocked(hash, data, length);
+            if (cached) return cached;
+        }
+        
+        // Copie des octets hors verrou; un autre thread a pu insérer les mêmes octets entre-temps
+        std::shared_ptr<FootImageGraph> graph = std::make_shared<FootImageGraph>(data, length);
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<FootImageGraph> cached = findLocked(hash, data, length);
+        if (cached) return cached;
+        entries_.push_front(Entry{hash, graph, static_cast<size_t>(length)});
+        evict();
+        return graph;
+    }
+    
+    // Fin d'utilisation: tampons de travail libérés, mémoire de l'entrée recomptée
+    void release(const std::shared_ptr<FootImageGraph>& graph) {
+        size_t bytes;
+        {
+            std::lock_guard<std::mutex> graph_lock(graph->mutex());
+            graph->releaseScratch();
+            graph->releaseRedecodable();
+            bytes = graph->memoryBytes();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entry& entry : entries_) {
+            if (entry.graph == graph) entry.bytes = bytes;
+        }
+        evict();
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+    
+private:
+    struct Entry {
+        uint64_t hash;
+        std::shared_ptr<FootImageGraph> graph;
+        size_t bytes;
+    };
+    
+    // Entrée de ces octets remise en tête (verrou tenu par l'appelant)
+    std::shared_ptr<FootImageGraph> findLocked(uint64_t hash, const uint8_t* data, int length) {
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->hash == hash && it->graph->matches(data, length)) {
+                entries_.splice(entries_.begin(), entries_, it);
+                LOGD("♻️ Cache: image retrouvée (%d octets)", length);
+                return it->graph;
+            }
+        }
+        return nullptr;
+    }
+    
+    // Moins récentes d'abord; une entrée encore utilisée reste valide pour ses détenteurs
+    void evict() {
+        size_t total = 0;
+        for (const Entry& entry : entries_) total += entry.bytes;
+        while (!entries_.empty() &&
+               (entries_.size() > kFootImageCacheMaxEntries || total > kFootImageCacheMaxBytes)) {
+            total -= entries_.back().bytes;
+            LOGD("🗑️ Cache: entrée évincée (%.1f Mo)", entries_.back().bytes / 1048576.0);
+            entries_.pop_back();
+        }
+    }
+    
+    std::mutex mutex_;
+    std::list<Entry> entries_;
+};
+
+FootImageCache& footImageCache() {
+    static FootImageCache cache;
+    return cache;
+}
+
+// Handle exporté: référence partagée avec le cache
+struct FootImageHandle {
+    std::shared_ptr<FootImageGraph> graph;
+};
+
+// Les octets sont comparés au cache: une image déjà analysée est reprise telle quelle,
+// sinon copiée; rien n'est décodé avant la première sortie demandée
+__attribute__((visibility("default")))
+void* createFootImage(const uint8_t* data, int length) {
+    if (data == nullptr || length <= 0) {
+        LOGE("Paramètres invalides");
+        return nullptr;
+    }
+    
+    try {
+        return new FootImageHandle{footImageCache().acquire(data, length)};
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception createFootImage: %s", e.what());
+        return nullptr;
+    }
+}
+
+// outResult: FootMeasurementResult fourni par l'appelant (stage_ms: seules les étapes recalculées
+// par cet appel). Retourne 1 si un pied a été mesuré; la calibration est remplie dans tous les cas.
+__attribute__((visibility("default")))
+int footImageMeasure(void* image, double qr_size_cm, FootMeasurementResult* outResult) {
+    if (image == nullptr || !resetMeasurementResult(outResult)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    try {
+        FootImageGraph& graph = *static_cast<FootImageHandle*>(image)->graph;
+        return processFootImageWith(graph, qr_size_cm, outResult, nullptr, nullptr, nullptr, nullptr);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception footImageMeasure: %s", e.what());
+        return 0;
+    }
+}
+
+// output: FootImageOutput. qr_size_cm n'est utilisé que par FOOT_OUTPUT_ANNOTATED.
+// Image à libérer avec freeMemory, ou releaseImageBuffer(*outHandle) si outHandle est fourni.
+__attribute__((visibility("default")))
+uint8_t* footImageRender(void* image, int output, double qr_size_cm, FootEncodeOptions* options,
+                         int* outSize, void** outHandle) {
+    if (image == nullptr || outSize == nullptr || !validEncodeOptions(options)) {
+        LOGE("Paramètres invalides");
+        if (outSize != nullptr) *outSize = 0;
+        return nullptr;
+    }
+    *outSize = 0;
+    if (outHandle != nullptr) *outHandle = nullptr;
+    
+    FootImageGraph& graph = *static_cast<FootImageHandle*>(image)->graph;
+    std::lock_guard<std::mutex> lock(graph.mutex());
+    try {
+        CallTimer call_timer(graph.workspace(), nullptr);
+        return renderFootImageOutput(graph, output, qr_size_cm, options, outSize, outHandle);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception footImageRender: %s", e.what());
+        *outSize = 0;
+        return nullptr;
+    }
+}
+
+__attribute__((visibility("default")))
+void destroyFootImage(void* image) {
+    std::unique_ptr<FootImageHandle> handle(static_cast<FootImageHandle*>(image));
+    if (handle == nullptr) return;
+    try {
+        footImageCache().release(handle->graph);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception destroyFootImage: %s", e.what());
+    }
+}
+
+// Vide le cache (pression mémoire); les handles ouverts restent valides
+__attribute__((visibility("default")))
+void clearFootImageCache() {
+    footImageCache().clear();
+}
+
+// ============================================================================
+// API CAMÉRA: trame YUV420 brute (CameraImage), sans encodage/décodage JPEG
+// Seul le plan Y est lu: calibration et segmentation travaillent en luminance.
+// ============================================================================
+
+// Enveloppe le plan Y (sans copie) et le redresse selon l'orientation du capteur
+cv::Mat wrapLumaPlane(const uint8_t* y_plane, int width, int height, int row_stride, int rotation_degrees) {
+    cv::Mat luma(height, width, CV_8UC1, const_cast<uint8_t*>(y_plane), static_cast<size_t>(row_stride));
+    
+    switch (((rotation_degrees % 360) + 360) % 360) {
+        case 90: {
+            cv::Mat rotated;
+            cv::rotate(luma, rotated, cv::ROTATE_90_CLOCKWISE);
+            return rotated;
+        }
+        case 180: {
+            cv::Mat rotated;
+            cv::rotate(luma, rotated, cv::ROTATE_180);
+            return rotated;
+        }
+        case 270: {
+            cv::Mat rotated;
+            cv::rotate(luma, rotated, cv::ROTATE_90_COUNTERCLOCKWISE);
+            return rotated;
+        }
+        default:
+            return luma;
+    }
+}
+
+// outResult: FootMeasurementResult fourni par l'appelant (coordonnées dans l'image redressée).
+// Retourne 1 si un contour a été mesuré.
+__attribute__((visibility("default")))
+int measureFootFromYUV420(const uint8_t* y_plane, int width, int height, int y_row_stride,
+                          int rotation_degrees, double qr_size_cm, FootMeasurementResult* outResult) {
+    LOGI("🎥 measureFootFromYUV420 (%dx%d, rot=%d, QR: %.1f cm)", width, height, rotation_degrees, qr_size_cm);
+    
+    if (y_plane == nullptr || width <= 0 || height <= 0 || y_row_stride < width || !resetMeasurementResult(outResult)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    try {
+        PipelineWorkspace workspace;
+        CallTimer call_timer(workspace, outResult);
+        cv::Mat img_gray;
+        {
+            StageTimer timer(workspace, FOOT_STAGE_DECODE);
+            img_gray = wrapLumaPlane(y_plane, width, height, y_row_stride, rotation_degrees);
+        }
+        
+        RobustCalibrationData calibration;
+        size_t best_contour_idx = 0;
+        FootMeasurements foot_measurements;
+        if (!analyzeFootFromGray(workspace, img_gray, qr_size_cm, calibration, best_contour_idx, foot_measurements)) {
+            fillCalibrationResult(calibration, outResult);
+            return 0;
+        }
+        
+        fillMeasurementResult(foot_measurements, calibration, img_gray.size(), outResult);
+        LOGI("✅ measureFootFromYUV420 terminée");
+        return 1;
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception measureFootFromYUV420: %s", e.what());
+        return 0;
+    }
+}
+
+// ============================================================================
+// SUIVI EN DIRECT: session à état alimentée par le flux de prévisualisation
+// Segmentation à résolution réduite, coins du QR suivis d'une trame à l'autre.
+// ============================================================================
+
+// Disposition du tableau de résultat par trame (coordonnées normalisées 0..1)
+enum TrackingField {
+    TRACK_FOUND = 0,
+    TRACK_CALIBRATED,
+    TRACK_BBOX_X,
+    TRACK_BBOX_Y,
+    TRACK_BBOX_W,
+    TRACK_BBOX_H,
+    TRACK_HEEL_X,
+    TRACK_HEEL_Y,
+    TRACK_TOE_X,
+    TRACK_TOE_Y,
+    TRACK_LEFT_X,
+    TRACK_LEFT_Y,
+    TRACK_RIGHT_X,
+    TRACK_RIGHT_Y,
+    TRACK_PIXELS_PER_CM,
+    TRACK_LENGTH_CM,
+    TRACK_WIDTH_CM,
+    TRACK_FIELD_COUNT
+};
+
+// Côté long de l'image de travail: suffisant pour la forme, ~1ms de segmentation
+const int kTrackingWorkingLongEdge = 640;
+// Trames entre deux détections QR tant qu'aucun QR n'est suivi
+const int kTrackingQRIntervalSearching = 5;
+// Trames sans pied avant de déclarer la perte
+const int kTrackingMaxMissedFrames = 5;
+// Lissage exponentiel des points (poids de la nouvelle trame)
+const float kTrackingSmoothing = 0.5f;
+
+// Suivi des coins du QR: fenêtre autour du QR (fraction de sa taille), flux optique pyramidal
+const double kQRTrackWindowMargin = 0.75;
+const int kQRTrackPyramidLevels = 3;
+// Confiance: erreur aller-retour du flux (pixels) et variation d'aire du quadrilatère entre trames
+const float kQRTrackMaxForwardBackward = 1.0f;
+const double kQRTrackMaxAreaChange = 0.25;
+// Détection complète de contrôle malgré un suivi valide (dérive), ~5 s à 30 i/s
+const int kQRTrackRefreshFrames = 150;
+
+// Coins du QR suivis entre trames: une détection complète (détection + décodage, dizaines de ms),
+// puis flux optique Lucas-Kanade des quatre coins dans une fenêtre autour du QR (~1 ms).
+// Départ du flux: coins prédits par l'homographie inter-trames précédente (mouvement propagé).
+// Calibration recalculée à chaque trame à partir des coins suivis: taille redressée de la dernière
+// détection mise à l'échelle par sqrt(aire suivie / aire détectée); contenu et modules conservés.
+class QRCornerTracker {
+public:
+    // Retourne true si la calibration de la trame a été mise à jour (suivi ou détection)
+    bool update(PipelineWorkspace& workspace, const cv::Mat& frame_gray, double qr_size_cm,
+                RobustCalibrationData& calibration) {
+        frames_since_detect_++;
+        if (tracking_ && frames_since_detect_ < kQRTrackRefreshFrames) {
+            if (track(workspace, frame_gray)) {
+                calibration = calibrateFromQR(detection_, qr_size_cm);
+                return true;
+            }
+            LOGD("🎯 Suivi QR perdu, redétection");
+            tracking_ = false;
+        } else if (!tracking_ && frames_since_detect_ < kTrackingQRIntervalSearching) {
+            return false;
+        }
+        
+        frames_since_detect_ = 0;
+        QRDetection detection = detectQRCodeWith(workspace, frame_gray, cv::Mat());
+        if (!detection.found) {
+            // Contrôle périodique manqué: le suivi reste valable s'il tient encore
+            if (tracking_ && track(workspace, frame_gray)) {
+                calibration = calibrateFromQR(detection_, qr_size_cm);
+                return true;
+            }
+            tracking_ = false;
+            return false;
+        }
+        
+        detection_ = detection;
+        detected_area_ = cv::contourArea(detection_.quad);
+        detected_straight_size_ = detection_.straight_size;
+        motion_ = cv::Mat::eye(3, 3, CV_64F);
+        tracking_ = true;
+        storeWindow(frame_gray);
+        calibration = calibrateFromQR(detection_, qr_size_cm);
+        return true;
+    }
+    
+private:
+    // Flux optique des coins de la fenêtre de la trame précédente vers la même fenêtre de la trame courante
+    bool track(PipelineWorkspace& workspace, const cv::Mat& frame_gray) {
+        StageTimer timer(workspace, FOOT_STAGE_QR);
+        if (frame_gray.size() != frame_size_) return false;
+        
+        cv::Point2f origin(static_cast<float>(window_.x), static_cast<float>(window_.y));
+        std::vector<cv::Point2f>& previous = previous_points_;
+        std::vector<cv::Point2f>& current = current_points_;
+        cv::perspectiveTransform(detection_.quad, current, motion_);
+        previous.resize(detection_.quad.size());
+        for (size_t i = 0; i < previous.size(); i++) {
+            previous[i] = detection_.quad[i] - origin;
+            current[i] -= origin;
+        }
+        
+        cv::Mat frame_window = frame_gray(window_);
+        cv::Size lk_window(21, 21);
+        cv::TermCriteria criteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03);
+        cv::calcOpticalFlowPyrLK(window_patch_, frame_window, previous, current, status_, error_,
+                                 lk_window, kQRTrackPyramidLevels, criteria, cv::OPTFLOW_USE_INITIAL_FLOW);
+        cv::calcOpticalFlowPyrLK(frame_window, window_patch_, current, backward_points_, backward_status_, error_,
+                                 lk_window, kQRTrackPyramidLevels, criteria);
+        for (size_t i = 0; i < previous.size(); i++) {
+            if (!status_[i] || !backward_status_[i] ||
+                cv::norm(backward_points_[i] - previous[i]) > kQRTrackMaxForwardBackward) {
+                return false;
+            }
+            current[i] += origin;
+        }
+        
+        double previous_area = cv::contourArea(detection_.quad);
+        double area = cv::contourArea(current);
+        if (!cv::isContourConvex(current) ||
+            std::fabs(area - previous_area) > kQRTrackMaxAreaChange * previous_area) {
+            return false;
+        }
+        
+        motion_ = cv::getPerspectiveTransform(detection_.quad, current);
+        detection_.quad = current;
+        
+        // QR rapproché ou éloigné: taille redressée suivant l'aire du quadrilatère suivi
+        double scale = detected_area_ > 0.0 ? std::sqrt(area / detected_area_) : 1.0;
+        detection_.straight_size = cv::Size2d(detected_straight_size_.width * scale,
+                                              detected_straight_size_.height * scale);
+        storeWindow(frame_gray);
+        return true;
+    }
+    
+    // Fenêtre de la trame suivante: QR courant élargi, pixels copiés (le plan Y n'appartient pas au suivi)
+    void storeWindow(const cv::Mat& frame_gray) {
+        cv::Rect box = cv::boundingRect(detection_.quad);
+        int margin = cvCeil(kQRTrackWindowMargin * std::max(box.width, box.height));
+        window_ = cv::Rect(box.x - margin, box.y - margin, box.width + 2 * margin, box.height + 2 * margin) &
+                  cv::Rect(0, 0, frame_gray.cols, frame_gray.rows);
+        frame_gray(window_).copyTo(window_patch_);
+        frame_size_ = frame_gray.size();
+    }
+    
+    bool tracking_ = false;
+    int frames_since_detect_ = kTrackingQRIntervalSearching;
+    QRDetection detection_;
+    double detected_area_ = 0.0;
+    cv::Size2d detected_straight_size_;
+    cv::Mat motion_;
+    cv::Size frame_size_;
+    cv::Rect window_;
+    cv::Mat window_patch_;
+    std::vector<cv::Point2f> previous_points_;
+    std::vector<cv::Point2f> current_points_;
+    std::vector<cv::Point2f> backward_points_;
+    std::vector<uchar> status_;
+    std::vector<uchar> backward_status_;
+    std::vector<float> error_;
+};
+
+class FootTrackingSession {
+public:
+    explicit FootTrackingSession(double qr_size_cm)
+        : qr_size_cm_(qr_size_cm), missed_frames_(0), has_foot_(false) {
+        last_calibration_.is_calibrated = false;
+        last_calibration_.pixels_per_cm = 0.0;
+        last_calibration_.qr_modules = 0;
+        last_calibration_.perspective_ratio = 1.0;
+    }
+
+    bool processFrame(const cv::Mat& frame_gray, double* out) {
+        CallTimer call_timer(workspace_, nullptr);
+        for (int i = 0; i < TRACK_FIELD_COUNT; i++) out[i] = 0.0;
+        
+        // Calibration: coins du QR suivis à chaque trame; dernière calibration valide gardée sinon
+        RobustCalibrationData calibration;
+        if (qr_tracker_.update(workspace_, frame_gray, qr_size_cm_, calibration) &&
+            (calibration.is_calibrated || !last_calibration_.is_calibrated)) {
+            last_calibration_ = calibration;
+        }
+        
+        // Image de travail réduite
+        double scale = std::min(1.0, static_cast<double>(kTrackingWorkingLongEdge) / std::max(frame_gray.cols, frame_gray.rows));
+        if (scale < 1.0) {
+            cv::resize(frame_gray, work_gray_, cv::Size(), scale, scale, cv::INTER_AREA);
+        } else {
+            frame_gray.copyTo(work_gray_);
+        }
+        
+        const AdaptiveParams& params = workspace_.adaptiveParams(work_gray_.size());
+        
+        size_t best_contour_idx = 0;
+        if (!segmentFootAdaptive(workspace_, work_gray_, params, best_contour_idx)) {
+            return reportPrevious(out);
+        }
+        std::vector<std::vector<cv::Point>>& contours = workspace_.contours;
+        
+        // Calibration ramenée à l'échelle de travail
+        RobustCalibrationData work_calibration = last_calibration_;
+        work_calibration.pixels_per_cm *= scale;
+        work_calibration.qr_center *= static_cast<float>(scale);
+        
+        FootMeasurements measurements = analyzeFootShapeAdaptive(contours[best_contour_idx], work_calibration, work_gray_.size());
+        cv::Rect bbox = cv::boundingRect(contours[best_contour_idx]);
+        last_contour_.swap(contours[best_contour_idx]);
+        
+        // Normalisation et lissage temporel
+        float inv_w = 1.0f / work_gray_.cols;
+        float inv_h = 1.0f / work_gray_.rows;
+        cv::Point2f points[4] = {
+            measurements.heel_point, measurements.toe_point, measurements.left_point, measurements.right_point
+        };
+        float box[4] = { bbox.x * inv_w, bbox.y * inv_h, bbox.width * inv_w, bbox.height * inv_h };
+        for (int i = 0; i < 4; i++) {
+            cv::Point2f normalized(points[i].x * inv_w, points[i].y * inv_h);
+            points_[i] = has_foot_ ? points_[i] + (normalized - points_[i]) * kTrackingSmoothing : normalized;
+            box_[i] = has_foot_ ? box_[i] + (box[i] - box_[i]) * kTrackingSmoothing : box[i];
+        }
+        length_cm_ = has_foot_ ? length_cm_ + (measurements.length_cm - length_cm_) * kTrackingSmoothing : measurements.length_cm;
+        width_cm_ = has_foot_ ? width_cm_ + (measurements.width_cm - width_cm_) * kTrackingSmoothing : measurements.width_cm;
+        has_foot_ = true;
+        missed_frames_ = 0;
+        
+        writeFrame(out);
+        return true;
+    }
+
+private:
+    // Pied momentanément perdu: on garde la dernière position quelques trames
+    bool reportPrevious(double* out) {
+        if (!has_foot_ || ++missed_frames_ > kTrackingMaxMissedFrames) {
+            has_foot_ = false;
+            last_contour_.clear();
+            out[TRACK_CALIBRATED] = last_calibration_.is_calibrated ? 1.0 : 0.0;
+            out[TRACK_PIXELS_PER_CM] = last_calibration_.pixels_per_cm;
+            return false;
+        }
+        writeFrame(out);
+        return true;
+    }
+
+    void writeFrame(double* out) const {
+        out[TRACK_FOUND] = 1.0;
+        out[TRACK_CALIBRATED] = last_calibration_.is_calibrated ? 1.0 : 0.0;
+        out[TRACK_BBOX_X] = box_[0];
+        out[TRACK_BBOX_Y] = box_[1];
+        out[TRACK_BBOX_W] = box_[2];
+        out[TRACK_BBOX_H] = box_[3];
+        for (int i = 0; i < 4; i++) {
+            out[TRACK_HEEL_X + 2 * i] = points_[i].x;
+            out[TRACK_HEEL_Y + 2 * i] = points_[i].y;
+        }
+        out[TRACK_PIXELS_PER_CM] = last_calibration_.pixels_per_cm;
+        out[TRACK_LENGTH_CM] = length_cm_;
+        out[TRACK_WIDTH_CM] = width_cm_;
+    }
+
+    double qr_size_cm_;
+    int missed_frames_;
+    bool has_foot_;
+    RobustCalibrationData last_calibration_;
+    QRCornerTracker qr_tracker_;
+    std::vector<cv::Point> last_contour_;
+    PipelineWorkspace workspace_;
+    cv::Mat work_gray_;
+    cv::Point2f points_[4];
+    float box_[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    double length_cm_ = 0.0;
+    double width_cm_ = 0.0;
+};
+
+__attribute__((visibility("default")))
+void* createFootTracker(double qr_size_cm) {
+    LOGI("🎥 createFootTracker (QR: %.1f cm)", qr_size_cm);
+    try {
+        return new FootTrackingSession(qr_size_cm);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception createFootTracker: %s", e.what());
+        return nullptr;
+    }
+}
+
+// outFrame: TRACK_FIELD_COUNT doubles fournis par l'appelant. Retourne 1 si un pied est suivi.
+__attribute__((visibility("default")))
+int trackFootFrame(void* tracker, const uint8_t* y_plane, int width, int height, int y_row_stride,
+                   int rotation_degrees, double* outFrame) {
+    if (tracker == nullptr || y_plane == nullptr || outFrame == nullptr ||
+        width <= 0 || height <= 0 || y_row_stride < width) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    try {
+        cv::Mat frame_gray = wrapLumaPlane(y_plane, width, height, y_row_stride, rotation_degrees);
+        return static_cast<FootTrackingSession*>(tracker)->processFrame(frame_gray, outFrame) ? 1 : 0;
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception trackFootFrame: %s", e.what());
+        return 0;
+    }
+}
+
+__attribute__((visibility("default")))
+void destroyFootTracker(void* tracker) {
+    delete static_cast<FootTrackingSession*>(tracker);
+}
+
+// Suivi sur un thread dédié: une trame au plus en cours, les suivantes sont refusées
+// (le flux caméra n'attend jamais le suivi, le thread UI non plus)
+class FootTrackingWorker {
+public:
+    FootTrackingWorker(double qr_size_cm, FootFrameCallback callback)
+        : session_(qr_size_cm), callback_(callback), has_frame_(false), busy_(false), stopping_(false) {
+        thread_ = std::thread([this]() { run(); });
+    }
+    
+    // Termine la trame soumise: ses tampons restent valides jusqu'au retour
+    ~FootTrackingWorker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        frame_cv_.notify_one();
+        thread_.join();
+    }
+    
+    bool submit(const uint8_t* y_plane, int width, int height, int y_row_stride, int rotation_degrees,
+                double* out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (busy_ || stopping_) return false;
+        y_plane_ = y_plane;
+        width_ = width;
+        height_ = height;
+        y_row_stride_ = y_row_stride;
+        rotation_degrees_ = rotation_degrees;
+        out_ = out;
+        has_frame_ = true;
+        busy_ = true;
+        frame_cv_.notify_one();
+        return true;
+    }
+    
+private:
+    void run() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                frame_cv_.wait(lock, [this]() { return stopping_ || has_frame_; });
+                if (!has_frame_) return;
+                has_frame_ = false;
+            }
+            
+            int status = 0;
+            try {
+                cv::Mat frame_gray = wrapLumaPlane(y_plane_, width_, height_, y_row_stride_, rotation_degrees_);
+                status = session_.processFrame(frame_gray, out_) ? 1 : 0;
+            } catch (const std::exception& e) {
+                LOGE("❌ Exception suivi: %s", e.what());
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                busy_ = false;
+            }
+            callback_(status);
+        }
+    }
+    
+    FootTrackingSession session_;
+    FootFrameCallback callback_;
+    const uint8_t* y_plane_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int y_row_stride_ = 0;
+    int rotation_degrees_ = 0;
+    double* out_ = nullptr;
+    bool has_frame_;
+    bool busy_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable frame_cv_;
+    std::thread thread_;
+};
+
+__attribute__((visibility("default")))
+void* createFootTrackerWorker(double qr_size_cm, FootFrameCallback callback) {
+    LOGI("🎥 createFootTrackerWorker (QR: %.1f cm)", qr_size_cm);
+    if (callback == nullptr) {
+        LOGE("Paramètres invalides");
+        return nullptr;
+    }
+    
+    try {
+        return new FootTrackingWorker(qr_size_cm, callback);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception createFootTrackerWorker: %s", e.what());
+        return nullptr;
+    }
+}
+
+// Comme trackFootFrame, sans attendre: y_plane et outFrame doivent rester valides jusqu'au
+// callback. Retourne 1 si la trame est acceptée, 0 si une trame est déjà en cours (ignorée).
+__attribute__((visibility("default")))
+int submitFootFrame(void* worker, const uint8_t* y_plane, int width, int height, int y_row_stride,
+                    int rotation_degrees, double* outFrame) {
+    if (worker == nullptr || y_plane == nullptr || outFrame == nullptr ||
+        width <= 0 || height <= 0 || y_row_stride < width) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    return static_cast<FootTrackingWorker*>(worker)->submit(y_plane, width, height, y_row_stride,
+                                                            rotation_degrees, outFrame) ? 1 : 0;
+}
+
+// Attend la fin de la trame en cours
+__attribute__((visibility("default")))
+void destroyFootTrackerWorker(void* worker) {
+    delete static_cast<FootTrackingWorker*>(worker);
+}
+
+// ============================================================================
+// FILE DE TRAITEMENT ASYNCHRONE: workers natifs, images analysées via le cache
+// (une capture resoumise ne repasse que par calibration, mesures, dessin et encodage).
+// Deux sortes de tâches: image annotée (submitFootJob) ou superposition vectorielle
+// (submitFootOverlayJob), chacune récupérée par sa fonction take.
+// submitFootJob rend la main immédiatement; la fin de chaque tâche est signalée
+// par le callback (NativeCallable.listener côté Dart, appelable depuis tout thread).
+// ============================================================================
+
+// Nombre de workers par défaut: chaque image en cours garde des tampons de plusieurs Mo
+const int kJobQueueMaxWorkers = 4;
+
+struct FootJob {
+    int64_t id = 0;
+    uint8_t* data = nullptr;
+    int length = 0;
+    double qr_size_cm = 0.0;
+    bool want_image = false;
+    bool want_overlay = false;
+    bool has_encode_options = false;
+    FootEncodeOptions encode_options;
+    
+    int status = 0;
+    FootMeasurementResult result;
+    FootOverlay overlay;
+    uint8_t* image = nullptr;
+    int image_size = 0;
+    void* image_handle = nullptr;
+    
+    ~FootJob() {
+        free(data);
+        // Résultat jamais récupéré
+        if (image_handle != nullptr) releaseImageBuffer(image_handle);
+    }
+};
+
+class FootJobQueue {
+public:
+    FootJobQueue(int worker_count, FootJobCallback callback)
+        : callback_(callback), next_id_(1), stopping_(false) {
+        for (int i = 0; i < worker_count; i++) {
+            workers_.emplace_back([this]() { workerLoop(); });
+        }
+        LOGI("🧵 File de traitement: %d workers", worker_count);
+    }
+    
+    ~FootJobQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        pending_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+    
+    int64_t submit(std::unique_ptr<FootJob> job) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->id = next_id_++;
+        int64_t id = job->id;
+        pending_.push_back(std::move(job));
+        pending_cv_.notify_one();
+        return id;
+    }
+    
+    std::unique_ptr<FootJob> take(int64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = completed_.find(id);
+        if (it == completed_.end()) return nullptr;
+        std::unique_ptr<FootJob> job = std::move(it->second);
+        completed_.erase(it);
+        return job;
+    }
+    
+private:
+    void workerLoop() {
+        while (true) {
+            std::unique_ptr<FootJob> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                pending_cv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+                if (stopping_) return;
+                job = std::move(pending_.front());
+                pending_.pop_front();
+            }
+            
+            job->result.struct_size = sizeof(FootMeasurementResult);
+            job->overlay.struct_size = sizeof(FootOverlay);
+            job->status = runJob(*job);
+            // Image encodée: l'entrée n'est plus nécessaire
+            free(job->data);
+            job->data = nullptr;
+            
+            int64_t id = job->id;
+            int status = job->status;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                completed_[id] = std::move(job);
+            }
+            callback_(id, status);
+        }
+    }
+    
+    static int runJob(FootJob& job) {
+        resetMeasurementResult(&job.result);
+        resetFootOverlay(&job.overlay);
+        try {
+            std::shared_ptr<FootImageGraph> graph = footImageCache().acquire(job.data, job.length);
+            int status = job.want_overlay
+                ? measureFootImageOverlayWith(*graph, job.qr_size_cm, &job.result, &job.overlay)
+                : processFootImageWith(*graph, job.qr_size_cm, &job.result,
+                                       job.want_image ? &job.image : nullptr,
+                                       job.want_image ? &job.image_size : nullptr,
+                                       &job.image_handle,
+                                       job.has_encode_options ? &job.encode_options : nullptr);
+            footImageCache().release(graph);
+            return status;
+        } catch (const std::exception& e) {
+            LOGE("❌ Exception tâche %lld: %s", static_cast<long long>(job.id), e.what());
+            return 0;
+        }
+    }
+    
+    FootJobCallback callback_;
+    int64_t next_id_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::deque<std::unique_ptr<FootJob>> pending_;
+    std::unordered_map<int64_t, std::unique_ptr<FootJob>> completed_;
+    std::vector<std::thread> workers_;
+};
+
+// worker_count <= 0: selon le nombre de cœurs (1 à kJobQueueMaxWorkers)
+__attribute__((visibility("default")))
+void* createJobQueue(int worker_count, FootJobCallback callback) {
+    if (callback == nullptr) {
+        LOGE("Paramètres invalides");
+        return nullptr;
+    }
+    if (worker_count <= 0) {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        worker_count = std::max(1, std::min(kJobQueueMaxWorkers, cores / 2));
+    }
+    
+    try {
+        return new FootJobQueue(worker_count, callback);
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception createJobQueue: %s", e.what());
+        return nullptr;
+    }
+}
+
+// data: tampon encodé alloué avec malloc, cédé à la file (libéré par free() après traitement).
+// want_image: 0 pour les mesures seules. options (copiées, optionnelles): format de l'image.
+// Retourne l'identifiant de la tâche, 0 en cas d'échec (data est alors toujours libéré).
+__attribute__((visibility("default")))
+int64_t submitFootJob(void* queue, uint8_t* data, int length, double qr_size_cm, int want_image,
+                      const FootEncodeOptions* options) {
+    if (queue == nullptr || data == nullptr || length <= 0 || !validEncodeOptions(options)) {
+        LOGE("Paramètres invalides");
+        free(data);
+        return 0;
+    }
+    
+    try {
+        std::unique_ptr<FootJob> job(new FootJob());
+        job->data = data;
+        job->length = length;
+        job->qr_size_cm = qr_size_cm;
+        job->want_image = want_image != 0;
+        if (options != nullptr) {
+            job->has_encode_options = true;
+            job->encode_options = *options;
+            job->encode_options.struct_size = sizeof(FootEncodeOptions);
+        }
+        return static_cast<FootJobQueue*>(queue)->submit(std::move(job));
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception submitFootJob: %s", e.what());
+        return 0;
+    }
+}
+
+// Mesures d'une tâche terminée dans la structure de l'appelant (taille et version conservées)
+void copyJobResult(const FootJob& job, FootMeasurementResult* outResult) {
+    uint32_t struct_size = outResult->struct_size;
+    uint32_t version = outResult->version;
+    std::memcpy(outResult, &job.result, std::min<size_t>(struct_size, sizeof(FootMeasurementResult)));
+    outResult->struct_size = struct_size;
+    outResult->version = version;
+}
+
+// Récupère le résultat d'une tâche signalée terminée (une seule fois par tâche).
+// outImage reçoit l'image cédée sans copie: à libérer avec releaseImageBuffer(*outHandle).
+// outOptions (optionnel) reçoit output_width/output_height de l'image produite.
+// Retourne le statut de la tâche (1 si un pied a été mesuré), 0 si la tâche est inconnue.
+__attribute__((visibility("default")))
+int takeFootJobResult(void* queue, int64_t job_id, FootMeasurementResult* outResult,
+                      uint8_t** outImage, int* outSize, void** outHandle, FootEncodeOptions* outOptions) {
+    if (queue == nullptr || outImage == nullptr || outSize == nullptr || outHandle == nullptr ||
+        !validEncodeOptions(outOptions) || !resetMeasurementResult(outResult)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    *outImage = nullptr;
+    *outSize = 0;
+    *outHandle = nullptr;
+    
+    std::unique_ptr<FootJob> job = static_cast<FootJobQueue*>(queue)->take(job_id);
+    if (!job) {
+        LOGE("Tâche inconnue: %lld", static_cast<long long>(job_id));
+        return 0;
+    }
+    copyJobResult(*job, outResult);
+    
+    *outImage = job->image;
+    *outSize = job->image_size;
+    *outHandle = job->image_handle;
+    job->image_handle = nullptr;
+    if (outOptions != nullptr && job->has_encode_options) {
+        outOptions->output_width = job->encode_options.output_width;
+        outOptions->output_height = job->encode_options.output_height;
+    }
+    return job->status;
+}
+
+// Tâche de superposition: mesures + contour, points clés et QR en vecteurs (aucune image produite).
+// data: comme submitFootJob. Résultat à récupérer par takeFootOverlayJobResult.
+__attribute__((visibility("default")))
+int64_t submitFootOverlayJob(void* queue, uint8_t* data, int length, double qr_size_cm) {
+    if (queue == nullptr || data == nullptr || length <= 0) {
+        LOGE("Paramètres invalides");
+        free(data);
+        return 0;
+    }
+    
+    try {
+        std::unique_ptr<FootJob> job(new FootJob());
+        job->data = data;
+        job->length = length;
+        job->qr_size_cm = qr_size_cm;
+        job->want_overlay = true;
+        return static_cast<FootJobQueue*>(queue)->submit(std::move(job));
+    } catch (const std::exception& e) {
+        LOGE("❌ Exception submitFootOverlayJob: %s", e.what());
+        return 0;
+    }
+}
+
+// Récupère le résultat d'une tâche de superposition (une seule fois par tâche).
+// Retourne le statut de la tâche (1 si un pied a été mesuré), 0 si la tâche est inconnue.
+__attribute__((visibility("default")))
+int takeFootOverlayJobResult(void* queue, int64_t job_id, FootMeasurementResult* outResult,
+                             FootOverlay* outOverlay) {
+    if (queue == nullptr || !resetMeasurementResult(outResult) || !resetFootOverlay(outOverlay)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    std::unique_ptr<FootJob> job = static_cast<FootJobQueue*>(queue)->take(job_id);
+    if (!job) {
+        LOGE("Tâche inconnue: %lld", static_cast<long long>(job_id));
+        return 0;
+    }
+    copyJobResult(*job, outResult);
+    
+    uint32_t struct_size = outOverlay->struct_size;
+    std::memcpy(outOverlay, &job->overlay, sizeof(FootOverlay));
+    outOverlay->struct_size = struct_size;
+    return job->status;
+}
+
+// Attend la fin des tâches en cours; les tâches non démarrées sont abandonnées sans callback
+__attribute__((visibility("default")))
+void destroyJobQueue(void* queue) {
+    delete static_cast<FootJobQueue*>(queue);
+}
+
+// ============================================================================
+// TRAITEMENT PAR LOTS: re-mesure d'archives de captures (outil footmeasure)
+// Une image par worker, un workspace par worker, répartition dynamique.
+// ============================================================================
+
+// Mesures seules (sans annotation) d'une image disque dans le workspace d'un worker
+int measureFootFileWith(PipelineWorkspace& workspace, const char* path, double qr_size_cm,
+                        FootMeasurementResult* outResult) {
+    outResult->struct_size = sizeof(FootMeasurementResult);
+    resetMeasurementResult(outResult);
+    CallTimer call_timer(workspace, outResult);
+    
+    workspace.img_bgr = loadImageWith(workspace, path);
+    if (workspace.img_bgr.empty()) {
+        LOGE("Image illisible: %s", path);
+        return 0;
+    }
+    {
+        StageTimer timer(workspace, FOOT_STAGE_GRAY);
+        cv::cvtColor(workspace.img_bgr, workspace.img_gray, cv::COLOR_BGR2GRAY);
+    }
+    
+    RobustCalibrationData calibration;
+    size_t best_contour_idx = 0;
+    FootMeasurements foot_measurements;
+    if (!analyzeFootFromGray(workspace, workspace.img_gray, qr_size_cm, calibration,
+                             best_contour_idx, foot_measurements)) {
+        fillCalibrationResult(calibration, outResult);
+        return 0;
+    }
+    
+    fillMeasurementResult(foot_measurements, calibration, workspace.img_gray.size(), outResult);
+    return 1;
+}
+
+// Mesure count images. worker_count <= 0: nombre de threads OpenCV.
+// Les workers tournent dans cv::parallel_for_: le prétraitement en bandes d'une image est
+// alors exécuté en série dans son worker, sans sur-souscription des cœurs.
+// callback: appelé une fois par image dès sa fin (ordre de fin, appels sérialisés).
+// Retourne le nombre d'images mesurées.
+__attribute__((visibility("default")))
+int processFootBatch(const char* const* paths, int count, double qr_size_cm, int worker_count,
+                     FootBatchCallback callback, void* user_data) {
+    if (paths == nullptr || count <= 0 || callback == nullptr) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    if (worker_count <= 0) {
+        worker_count = cv::getNumThreads();
+    }
+    worker_count = std::max(1, std::min(worker_count, count));
+    LOGI("📦 processFootBatch: %d images, %d workers", count, worker_count);
+    
+    std::atomic<int> next_index(0);
+    std::atomic<int> measured(0);
+    std::mutex callback_mutex;
+    
+    cv::parallel_for_(cv::Range(0, worker_count), [&](const cv::Range& range) {
+        for (int worker = range.start; worker < range.end; worker++) {
+            PipelineWorkspace workspace;
+            FootMeasurementResult result;
+            
+            for (int index = next_index++; index < count; index = next_index++) {
+                int status = 0;
+                try {
+                    status = measureFootFileWith(workspace, paths[index], qr_size_cm, &result);
+                } catch (const std::exception& e) {
+                    LOGE("❌ Exception processFootBatch (%s): %s", paths[index], e.what());
+                    result.struct_size = sizeof(FootMeasurementResult);
+                    resetMeasurementResult(&result);
+                }
+                if (status) measured++;
+                
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                callback(user_data, index, paths[index], status, &result);
+            }
+        }
+    }, worker_count);
+    
+    LOGI("✅ processFootBatch: %d/%d mesurées", measured.load(), count);
+    return measured.load();
+}
+
+// Copie de l'histogramme cumulé des durées par étape. Retourne 1 si out a été rempli.
+__attribute__((visibility("default")))
+int getTimingHistogram(FootTimingHistogram* out) {
+    if (out == nullptr || out->struct_size < sizeof(FootTimingHistogram)) {
+        LOGE("Paramètres invalides");
+        return 0;
+    }
+    
+    const TimingHistogram& histogram = g_timing_histogram;
+    out->version = 1;
+    for (int stage = 0; stage < FOOT_STAGE_COUNT; stage++) {
+        out->count[stage] = histogram.count[stage].load(std::memory_order_relaxed);
+        out->total_ms[stage] = histogram.total_us[stage].load(std::memory_order_relaxed) / 1000.0;
+        out->max_ms[stage] = histogram.max_us[stage].load(std::memory_order_relaxed) / 1000.0;
+        for (int bucket = 0; bucket < FOOT_TIMING_BUCKETS; bucket++) {
+            out->buckets[stage][bucket] = histogram.buckets[stage][bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return 1;
+}
+
+__attribute__((visibility("default")))
+void resetTimingHistogram() {
+    TimingHistogram& histogram = g_timing_histogram;
+    for (int stage = 0; stage < FOOT_STAGE_COUNT; stage++) {
+        histogram.count[stage].store(0, std::memory_order_relaxed);
+        histogram.total_us[stage].store(0, std::memory_order_relaxed);
+        histogram.max_us[stage].store(0, std::memory_order_relaxed);
+        for (int bucket = 0; bucket < FOOT_TIMING_BUCKETS; bucket++) {
+            histogram.buckets[stage][bucket].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+__attribute__((visibility("default")))
 void freeMemory(uint8_t* ptr) {
     if (ptr != nullptr) {
         delete[] ptr;
     }
 }
 
+// Libère le tableau retourné par extractFootMeasurements (alloué avec new[])
+__attribute__((visibility("default")))
+void freeMeasurements(double* ptr) {
+    delete[] ptr;
+}
+
+// Libère un tampon cédé via outHandle (signature compatible NativeFinalizer)
+__attribute__((visibility("default")))
+void releaseImageBuffer(void* handle) {
+    delete static_cast<std::vector<uchar>*>(handle);
+}
+
+// Niveau de journalisation à l'exécution (3 = debug ... 6 = erreurs, 8 = silence).
+// Les niveaux sous NATIVE_LOG_LEVEL ne sont pas compilés et restent muets.
+__attribute__((visibility("default")))
+void setNativeLogLevel(int level) {
+    nativeLogRuntimeLevel().store(level, std::memory_order_relaxed);
+}
+
+// Niveau effectif: le plus restrictif entre l'exécution et la compilation
+__attribute__((visibility("default")))
+int getNativeLogLevel() {
+    return std::max(nativeLogRuntimeLevel().load(std::memory_order_relaxed), NATIVE_LOG_LEVEL);
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,251 @@
+#ifndef NATIVE_OPENCV_H
+#define NATIVE_OPENCV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// ABI C des résultats de mesure (miroir Dart: FootMeasurementResultStruct)
+// Mémoire fournie par l'appelant: aucune allocation native par appel.
+// L'appelant renseigne struct_size = sizeof(FootMeasurementResult) de son en-tête;
+// le natif ne remplit que les champs couverts, refuse une taille inférieure à la
+// version 1 et écrit dans version la plus haute version entièrement remplie.
+// Nouveaux champs: uniquement ajoutés en fin de structure, avec version + 1.
+// ============================================================================
+
+#define FOOT_MEASUREMENT_RESULT_VERSION 2
+#define FOOT_QR_CONTENT_MAX 256
+
+// Étapes chronométrées du pipeline (durées en ms)
+enum FootPipelineStage {
+    FOOT_STAGE_DECODE = 0,    // imread / imdecode
+    FOOT_STAGE_QR,            // détection, décodage et calibration QR
+    FOOT_STAGE_GRAY,          // conversion BGR -> niveaux de gris
+    FOOT_STAGE_BLUR,          // flou gaussien (+ histogramme en mode bandes)
+    FOOT_STAGE_THRESHOLD,     // fond, Otsu et seuillage
+    FOOT_STAGE_MORPHOLOGY,    // fermeture + ouverture (+ seuil fusionné en mode bandes)
+    FOOT_STAGE_CONTOURS,      // étiquetage des régions + tracé du contour retenu
+    FOOT_STAGE_FILTER,        // filtrage et tri des régions candidates
+    FOOT_STAGE_MEASURE,       // points extrêmes et conversion en cm
+    FOOT_STAGE_DRAW,          // annotations de l'image résultat
+    FOOT_STAGE_ENCODE,        // encodage de l'image résultat (PNG, JPEG ou RGBA)
+    FOOT_STAGE_TOTAL,         // appel complet
+    FOOT_STAGE_COUNT
+};
+
+typedef struct FootMeasurementResult {
+    uint32_t struct_size;
+    uint32_t version;
+
+    int32_t found;                // 1 si un pied a été mesuré
+    int32_t is_calibrated;        // 1 si l'échelle vient du QR
+    int32_t image_width;          // repère des coordonnées ci-dessous (pixels)
+    int32_t image_height;
+    int32_t qr_modules;
+    int32_t qr_content_length;    // octets utiles de qr_content (tronqué à FOOT_QR_CONTENT_MAX - 1)
+
+    // Mesures (cm)
+    double length_cm;
+    double width_cm;
+    double heel_to_arch_cm;
+    double arch_to_toe_cm;
+    double big_toe_length_cm;
+
+    // Points clés (pixels)
+    double heel_x, heel_y;
+    double toe_x, toe_y;
+    double left_x, left_y;
+    double right_x, right_y;
+
+    // Calibration QR
+    double pixels_per_cm;
+    double qr_center_x, qr_center_y;
+    double qr_size_pixels_raw;
+    double qr_size_pixels_corrected;
+    double perspective_ratio;
+
+    char qr_content[FOOT_QR_CONTENT_MAX];   // UTF-8, terminé par '\0'
+
+    // Version 2: durées de l'appel par étape (ms), indexées par FootPipelineStage
+    double stage_ms[FOOT_STAGE_COUNT];
+} FootMeasurementResult;
+
+// Histogramme des durées par étape, cumulé sur tout le processus
+// Une mesure par appel et par étape exécutée (somme des portées de l'étape dans l'appel).
+// buckets[s][b]: nombre de mesures de l'étape s dans [2^b, 2^(b+1)) µs (b = 0: < 2 µs)
+#define FOOT_TIMING_BUCKETS 32
+
+typedef struct FootTimingHistogram {
+    uint32_t struct_size;
+    uint32_t version;
+    uint64_t count[FOOT_STAGE_COUNT];
+    double total_ms[FOOT_STAGE_COUNT];
+    double max_ms[FOOT_STAGE_COUNT];
+    uint64_t buckets[FOOT_STAGE_COUNT][FOOT_TIMING_BUCKETS];
+} FootTimingHistogram;
+
+// ============================================================================
+// Image résultat: format, qualité et taille (pointeur nul = PNG pleine résolution)
+// L'appelant renseigne struct_size = sizeof(FootEncodeOptions).
+// ============================================================================
+
+enum FootImageFormat {
+    FOOT_IMAGE_PNG = 0,       // PNG (png_compression)
+    FOOT_IMAGE_JPEG = 1,      // JPEG (jpeg_quality)
+    FOOT_IMAGE_RGBA = 2       // pixels RGBA 8 bits bruts, output_width * output_height * 4 octets
+};
+
+typedef struct FootEncodeOptions {
+    uint32_t struct_size;
+    int32_t format;           // FootImageFormat
+    int32_t jpeg_quality;     // 1-100, 0 = 90
+    int32_t png_compression;  // 0 (aucune, plus rapide) à 9, -1 = défaut OpenCV
+    int32_t max_dimension;    // plus grand côté de l'image produite (0 = pleine résolution)
+
+    // Renseignés par le natif: dimensions de l'image produite
+    int32_t output_width;
+    int32_t output_height;
+} FootEncodeOptions;
+
+// ============================================================================
+// Superposition vectorielle (dessinée côté Flutter sur l'image d'origine)
+// Coordonnées en pixels de l'image décodée (image_width x image_height).
+// L'appelant renseigne struct_size = sizeof(FootOverlay).
+// ============================================================================
+
+#define FOOT_OVERLAY_VERSION 1
+#define FOOT_OVERLAY_MAX_POINTS 1024
+
+typedef struct FootOverlay {
+    uint32_t struct_size;
+    uint32_t version;
+
+    int32_t image_width;
+    int32_t image_height;
+    int32_t contour_point_count;  // sommets utiles de contour_xy (polyligne fermée)
+    int32_t has_qr_quad;          // 1 si qr_quad_xy est rempli
+
+    float keypoints_xy[8];        // talon, orteil, gauche, droite (x, y)
+    float qr_quad_xy[8];          // coins du QR dans l'ordre du détecteur (x, y)
+    float contour_xy[2 * FOOT_OVERLAY_MAX_POINTS];
+} FootOverlay;
+
+// Sorties d'une image analysée (footImageRender)
+enum FootImageOutput {
+    FOOT_OUTPUT_ANNOTATED = 0,            // image annotée (contour, points clés, QR, mesures)
+    FOOT_OUTPUT_BACKGROUND_REMOVED = 1,   // deux plus grandes régions sur fond uni (comme removeBackground)
+    FOOT_OUTPUT_MASK = 2,                 // masque du pied, 8 bits
+    FOOT_OUTPUT_EDGES = 3                 // contours Canny
+};
+
+// Fin d'une tâche de la file asynchrone (appelé depuis un thread worker)
+// status: 1 si un pied a été mesuré, 0 sinon. Résultat à récupérer par takeFootJobResult.
+typedef void (*FootJobCallback)(int64_t job_id, int32_t status);
+
+// Fin du suivi d'une trame soumise par submitFootFrame (appelé depuis le thread de suivi)
+// status: 1 si un pied est suivi; la trame est alors écrite dans outFrame.
+typedef void (*FootFrameCallback)(int32_t status);
+
+// Résultat d'une image d'un lot (processFootBatch). result n'est valide que pendant l'appel.
+typedef void (*FootBatchCallback)(void* user_data, int32_t index, const char* path,
+                                  int32_t status, const FootMeasurementResult* result);
+
+// ============================================================================
+// Fonctions exportées (libnative_opencv.so)
+// Images résultat (PNG, ou selon FootEncodeOptions) à libérer avec freeMemory, ou releaseImageBuffer(*outHandle)
+// quand outHandle est fourni (cession sans copie).
+// ============================================================================
+
+int testFunction(void);
+
+// Chemins de fichiers
+uint8_t* measureFootWithQR(const char* path, int* outSize, double qr_size_cm);
+uint8_t* processFootWithQR(const char* path, int* outSize, double qr_size_cm, FootMeasurementResult* outResult);
+double* extractFootMeasurements(const char* path, double qr_size_cm);
+uint8_t* processImage(const char* path, int* outSize);
+uint8_t* removeBackground(const char* path, int* outSize);
+
+// Images encodées en mémoire
+uint8_t* measureFootWithQRBuffer(const uint8_t* data, int length, int* outSize, double qr_size_cm, void** outHandle,
+                                 FootEncodeOptions* options);
+uint8_t* processFootWithQRBuffer(const uint8_t* data, int length, int* outSize,
+                                 double qr_size_cm, FootMeasurementResult* outResult, void** outHandle,
+                                 FootEncodeOptions* options);
+int extractFootMeasurementsBuffer(const uint8_t* data, int length, double qr_size_cm, FootMeasurementResult* outResult);
+uint8_t* processImageBuffer(const uint8_t* data, int length, int* outSize, void** outHandle,
+                            FootEncodeOptions* options);
+uint8_t* removeBackgroundBuffer(const uint8_t* data, int length, int* outSize, void** outHandle,
+                                FootEncodeOptions* options);
+
+// Mesures + superposition vectorielle, sans image résultat
+int measureFootOverlayBuffer(const uint8_t* data, int length, double qr_size_cm,
+                             FootMeasurementResult* outResult, FootOverlay* outOverlay);
+
+// Image analysée: étapes intermédiaires (décodage, QR, masque, contour...) mémorisées entre
+// les sorties demandées. Un handle n'est utilisé que par un appel à la fois (verrou interne).
+// Les images sont conservées dans un cache LRU borné, indexé par leur contenu encodé: rouvrir
+// les mêmes octets (ou resoumettre une tâche) ne recalcule que ce qui dépend de qr_size_cm.
+void* createFootImage(const uint8_t* data, int length);
+int footImageMeasure(void* image, double qr_size_cm, FootMeasurementResult* outResult);
+uint8_t* footImageRender(void* image, int output, double qr_size_cm, FootEncodeOptions* options,
+                         int* outSize, void** outHandle);
+void destroyFootImage(void* image);
+void clearFootImageCache(void);
+
+// Session de mesure (tampons réutilisés)
+void* createMeasurementSession(int width, int height);
+int sessionProcessFoot(void* session, const uint8_t* data, int length, double qr_size_cm,
+                       FootMeasurementResult* outResult, uint8_t** outImage, int* outSize, void** outHandle,
+                       FootEncodeOptions* options);
+int sessionMeasureFootOverlay(void* session, const uint8_t* data, int length, double qr_size_cm,
+                              FootMeasurementResult* outResult, FootOverlay* outOverlay);
+void destroyMeasurementSession(void* session);
+
+// Caméra et suivi en direct
+int measureFootFromYUV420(const uint8_t* y_plane, int width, int height, int y_row_stride,
+                          int rotation_degrees, double qr_size_cm, FootMeasurementResult* outResult);
+void* createFootTracker(double qr_size_cm);
+int trackFootFrame(void* tracker, const uint8_t* y_plane, int width, int height, int y_row_stride,
+                   int rotation_degrees, double* outFrame);
+void destroyFootTracker(void* tracker);
+void* createFootTrackerWorker(double qr_size_cm, FootFrameCallback callback);
+int submitFootFrame(void* worker, const uint8_t* y_plane, int width, int height, int y_row_stride,
+                    int rotation_degrees, double* outFrame);
+void destroyFootTrackerWorker(void* worker);
+
+// File de traitement asynchrone
+void* createJobQueue(int worker_count, FootJobCallback callback);
+int64_t submitFootJob(void* queue, uint8_t* data, int length, double qr_size_cm, int want_image,
+                      const FootEncodeOptions* options);
+int takeFootJobResult(void* queue, int64_t job_id, FootMeasurementResult* outResult,
+                      uint8_t** outImage, int* outSize, void** outHandle, FootEncodeOptions* outOptions);
+int64_t submitFootOverlayJob(void* queue, uint8_t* data, int length, double qr_size_cm);
+int takeFootOverlayJobResult(void* queue, int64_t job_id, FootMeasurementResult* outResult,
+                             FootOverlay* outOverlay);
+void destroyJobQueue(void* queue);
+
+// Traitement par lots (fichiers)
+int processFootBatch(const char* const* paths, int count, double qr_size_cm, int worker_count,
+                     FootBatchCallback callback, void* user_data);
+
+// Chronométrage: copie de l'histogramme cumulé (1 si rempli), remise à zéro
+int getTimingHistogram(FootTimingHistogram* out);
+void resetTimingHistogram(void);
+
+// Journalisation: niveau minimal à l'exécution (voir NATIVE_LOG_LEVEL_* dans native_log.h)
+void setNativeLogLevel(int level);
+int getNativeLogLevel(void);
+
+// Libération
+void freeMemory(uint8_t* ptr);
+void freeMeasurements(double* ptr);
+void releaseImageBuffer(void* handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_OPENCV_H
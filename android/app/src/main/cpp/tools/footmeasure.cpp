@@ -0,0 +1,316 @@
+// footmeasure: moteur de mesure natif en ligne de commande (build hôte)
+// Appelle les mêmes exports que l'application (extractFootMeasurements, measureFootWithQR,
+// processFootBatch), pour profiler (perf, valgrind) et tester sous sanitizers le code de production.
+//
+// Usage: footmeasure [--qr-size CM] [--annotate DOSSIER] [--timings] image...
+//        footmeasure --format csv|jsonl [--jobs N] [--list FICHIER] [--qr-size CM] [--timings] image|dossier...
+
+#include "../native_opencv.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--qr-size CM] [--annotate DOSSIER] [--timings] image...\n"
+                 "       %s --format csv|jsonl [--jobs N] [--list FICHIER] [--qr-size CM] [--timings] image|dossier...\n"
+                 "  --qr-size CM        côté réel du QR de calibration (défaut: 3.0)\n"
+                 "  --annotate DOSSIER  écrit l'image annotée (PNG) de chaque entrée dans DOSSIER\n"
+                 "  --format FORMAT     mode lot: résultats complets en CSV ou JSONL sur stdout\n"
+                 "  --jobs N            workers du mode lot (défaut: tous les cœurs)\n"
+                 "  --list FICHIER      chemins d'images, un par ligne ('-' pour stdin)\n"
+                 "  --timings           durées par étape (getTimingHistogram) sur stderr en fin de run\n",
+                 program, program);
+}
+
+const char* const kStageNames[FOOT_STAGE_COUNT] = {
+    "decode", "qr", "gray", "blur", "threshold", "morphology",
+    "contours", "filter", "measure", "draw", "encode", "total",
+};
+
+// Borne haute (ms) du seau contenant le rang demandé de l'histogramme
+double bucketPercentileMs(const uint64_t* buckets, uint64_t count, double fraction) {
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < FOOT_TIMING_BUCKETS; bucket++) {
+        seen += buckets[bucket];
+        if (seen > rank) return static_cast<double>(uint64_t(2) << bucket) / 1000.0;
+    }
+    return 0.0;
+}
+
+void printTimings() {
+    FootTimingHistogram histogram;
+    std::memset(&histogram, 0, sizeof(histogram));
+    histogram.struct_size = sizeof(histogram);
+    if (!getTimingHistogram(&histogram)) return;
+    
+    std::fprintf(stderr, "%-12s %8s %10s %10s %10s %10s\n", "stage", "count", "mean_ms", "p50_ms", "p95_ms", "max_ms");
+    for (int stage = 0; stage < FOOT_STAGE_COUNT; stage++) {
+        uint64_t count = histogram.count[stage];
+        if (count == 0) continue;
+        std::fprintf(stderr, "%-12s %8llu %10.2f %10.2f %10.2f %10.2f\n", kStageNames[stage],
+                     static_cast<unsigned long long>(count), histogram.total_ms[stage] / count,
+                     bucketPercentileMs(histogram.buckets[stage], count, 0.50),
+                     bucketPercentileMs(histogram.buckets[stage], count, 0.95), histogram.max_ms[stage]);
+    }
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+bool writeFile(const std::string& path, const uint8_t* data, int size) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool ok = std::fwrite(data, 1, static_cast<size_t>(size), file) == static_cast<size_t>(size);
+    return std::fclose(file) == 0 && ok;
+}
+
+bool isImageFile(const std::string& name) {
+    static const char* const extensions[] = {".jpg", ".jpeg", ".png", ".bmp", ".webp", ".tif", ".tiff"};
+    size_t dot = name.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string extension = name.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    for (const char* candidate : extensions) {
+        if (extension == candidate) return true;
+    }
+    return false;
+}
+
+// Fichier: ajouté tel quel. Dossier: images qu'il contient, triées (non récursif).
+void collectImages(const std::string& path, std::vector<std::string>& images) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        images.push_back(path);
+        return;
+    }
+    
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) return;
+    std::vector<std::string> entries;
+    while (dirent* entry = readdir(dir)) {
+        if (isImageFile(entry->d_name)) {
+            entries.push_back(path + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    images.insert(images.end(), entries.begin(), entries.end());
+}
+
+bool readList(const std::string& list, std::vector<std::string>& images) {
+    std::ifstream file;
+    if (list != "-") {
+        file.open(list);
+        if (!file) return false;
+    }
+    std::istream& input = list == "-" ? std::cin : file;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty()) images.push_back(line);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Mode lot: une ligne par image, dans l'ordre de fin de traitement
+// ---------------------------------------------------------------------------
+
+enum OutputFormat { FORMAT_CSV, FORMAT_JSONL };
+
+const char* const kCsvHeader =
+    "index,path,status,length_cm,width_cm,heel_to_arch_cm,arch_to_toe_cm,big_toe_length_cm,"
+    "is_calibrated,image_width,image_height,heel_x,heel_y,toe_x,toe_y,left_x,left_y,right_x,right_y,"
+    "pixels_per_cm,qr_center_x,qr_center_y,qr_size_pixels_raw,qr_size_pixels_corrected,"
+    "perspective_ratio,qr_modules,qr_content";
+
+std::string csvField(const char* text) {
+    std::string field = "\"";
+    for (const char* c = text; *c; c++) {
+        if (*c == '"') field += '"';
+        field += *c;
+    }
+    return field + "\"";
+}
+
+std::string jsonString(const char* text) {
+    std::string out = "\"";
+    for (const unsigned char* c = reinterpret_cast<const unsigned char*>(text); *c; c++) {
+        switch (*c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (*c < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                    out += escaped;
+                } else {
+                    out += static_cast<char>(*c);
+                }
+        }
+    }
+    return out + "\"";
+}
+
+void printBatchResult(void* user_data, int32_t index, const char* path, int32_t status,
+                      const FootMeasurementResult* r) {
+    OutputFormat format = *static_cast<OutputFormat*>(user_data);
+    if (format == FORMAT_CSV) {
+        std::printf("%d,%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,"
+                    "%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+                    "%.4f,%.2f,%.2f,%.2f,%.2f,%.4f,%d,%s\n",
+                    index, csvField(path).c_str(), status,
+                    r->length_cm, r->width_cm, r->heel_to_arch_cm, r->arch_to_toe_cm, r->big_toe_length_cm,
+                    r->is_calibrated, r->image_width, r->image_height,
+                    r->heel_x, r->heel_y, r->toe_x, r->toe_y, r->left_x, r->left_y, r->right_x, r->right_y,
+                    r->pixels_per_cm, r->qr_center_x, r->qr_center_y, r->qr_size_pixels_raw,
+                    r->qr_size_pixels_corrected, r->perspective_ratio, r->qr_modules,
+                    csvField(r->qr_content).c_str());
+    } else {
+        std::printf("{\"index\":%d,\"path\":%s,\"status\":%d,"
+                    "\"length_cm\":%.4f,\"width_cm\":%.4f,\"heel_to_arch_cm\":%.4f,\"arch_to_toe_cm\":%.4f,"
+                    "\"big_toe_length_cm\":%.4f,\"is_calibrated\":%s,\"image_width\":%d,\"image_height\":%d,"
+                    "\"heel\":[%.2f,%.2f],\"toe\":[%.2f,%.2f],\"left\":[%.2f,%.2f],\"right\":[%.2f,%.2f],"
+                    "\"calibration\":{\"pixels_per_cm\":%.4f,\"qr_center\":[%.2f,%.2f],"
+                    "\"qr_size_pixels_raw\":%.2f,\"qr_size_pixels_corrected\":%.2f,"
+                    "\"perspective_ratio\":%.4f,\"qr_modules\":%d,\"qr_content\":%s}}\n",
+                    index, jsonString(path).c_str(), status,
+                    r->length_cm, r->width_cm, r->heel_to_arch_cm, r->arch_to_toe_cm,
+                    r->big_toe_length_cm, r->is_calibrated ? "true" : "false", r->image_width, r->image_height,
+                    r->heel_x, r->heel_y, r->toe_x, r->toe_y, r->left_x, r->left_y, r->right_x, r->right_y,
+                    r->pixels_per_cm, r->qr_center_x, r->qr_center_y,
+                    r->qr_size_pixels_raw, r->qr_size_pixels_corrected,
+                    r->perspective_ratio, r->qr_modules, jsonString(r->qr_content).c_str());
+    }
+    // Flux continu: chaque ligne est visible dès que l'image est traitée
+    std::fflush(stdout);
+}
+
+int runBatch(const std::vector<std::string>& images, double qr_size_cm, int jobs, OutputFormat format) {
+    std::vector<const char*> paths;
+    paths.reserve(images.size());
+    for (const std::string& image : images) paths.push_back(image.c_str());
+    
+    if (format == FORMAT_CSV) {
+        std::printf("%s\n", kCsvHeader);
+    }
+    int measured = processFootBatch(paths.data(), static_cast<int>(paths.size()), qr_size_cm, jobs,
+                                    printBatchResult, &format);
+    std::fprintf(stderr, "%d/%zu images mesurées\n", measured, paths.size());
+    return measured == static_cast<int>(paths.size()) ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double qr_size_cm = 3.0;
+    const char* annotate_dir = nullptr;
+    const char* format_name = nullptr;
+    const char* list = nullptr;
+    int jobs = 0;
+    bool timings = false;
+    std::vector<std::string> inputs;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--qr-size") == 0 && i + 1 < argc) {
+            qr_size_cm = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--annotate") == 0 && i + 1 < argc) {
+            annotate_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format_name = argv[++i];
+        } else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            list = argv[++i];
+        } else if (std::strcmp(argv[i], "--timings") == 0) {
+            timings = true;
+        } else if (std::strcmp(argv[i], "--help") == 0 || argv[i][0] == '-') {
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    
+    if (format_name != nullptr) {
+        OutputFormat format;
+        if (std::strcmp(format_name, "csv") == 0) {
+            format = FORMAT_CSV;
+        } else if (std::strcmp(format_name, "jsonl") == 0) {
+            format = FORMAT_JSONL;
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+        
+        std::vector<std::string> images;
+        if (list != nullptr && !readList(list, images)) {
+            std::fprintf(stderr, "%s: liste illisible\n", list);
+            return 2;
+        }
+        for (const std::string& input : inputs) collectImages(input, images);
+        if (images.empty() || qr_size_cm <= 0.0 || annotate_dir != nullptr) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        int status = runBatch(images, qr_size_cm, jobs, format);
+        if (timings) printTimings();
+        return status;
+    }
+    
+    if (inputs.empty() || qr_size_cm <= 0.0 || list != nullptr) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    
+    int failures = 0;
+    for (const std::string& input : inputs) {
+        const char* path = input.c_str();
+        // [length, width, heel_to_arch, arch_to_toe, big_toe, is_calibrated]
+        double* measurements = extractFootMeasurements(path, qr_size_cm);
+        bool found = measurements != nullptr && measurements[0] > 0.0;
+        if (found) {
+            std::printf("%s: length=%.2f width=%.2f heel_to_arch=%.2f arch_to_toe=%.2f big_toe=%.2f calibrated=%d\n",
+                        path, measurements[0], measurements[1], measurements[2], measurements[3],
+                        measurements[4], measurements[5] > 0.5 ? 1 : 0);
+        } else {
+            std::printf("%s: échec\n", path);
+            failures++;
+        }
+        freeMeasurements(measurements);
+        
+        if (annotate_dir != nullptr) {
+            int size = 0;
+            uint8_t* png = measureFootWithQR(path, &size, qr_size_cm);
+            std::string output = std::string(annotate_dir) + "/" + baseName(input) + ".png";
+            if (png == nullptr || size == 0 || !writeFile(output, png, size)) {
+                std::fprintf(stderr, "%s: image annotée non écrite\n", output.c_str());
+                failures++;
+            }
+            freeMemory(png);
+        }
+    }
+    
+    if (timings) printTimings();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+import 'dart:ffi';
+import 'dart:ui';
+import 'package:camera/camera.dart';
+import 'package:ffi/ffi.dart';
+
+import 'opencv_service.dart';
+
+// Typedefs pour la session de suivi native (thread de suivi dédié)
+typedef FootFrameCallbackNative = Void Function(Int32 status);
+
+typedef CreateFootTrackerWorkerNative = Pointer<Void> Function(Double qrSize, Pointer<NativeFunction<FootFrameCallbackNative>> callback);
+typedef CreateFootTrackerWorkerDart = Pointer<Void> Function(double qrSize, Pointer<NativeFunction<FootFrameCallbackNative>> callback);
+
+typedef SubmitFootFrameNative = Int32 Function(Pointer<Void> worker, Pointer<Uint8> yPlane, Int32 width, Int32 height, Int32 yRowStride, Int32 rotationDegrees, Pointer<Double> outFrame);
+typedef SubmitFootFrameDart = int Function(Pointer<Void> worker, Pointer<Uint8> yPlane, int width, int height, int yRowStride, int rotationDegrees, Pointer<Double> outFrame);
+
+typedef DestroyFootTrackerWorkerNative = Void Function(Pointer<Void> worker);
+typedef DestroyFootTrackerWorkerDart = void Function(Pointer<Void> worker);
+
+/// Résultat léger d'une trame (coordonnées normalisées 0..1 dans l'image redressée)
+class FootTrackingFrame {
+  // Disposition identique à TrackingField côté natif
+  static const int fieldCount = 17;
+
+  final bool found;
+  final bool isCalibrated;
+  final Rect boundingBox;
+  final Offset heel;
+  final Offset toe;
+  final Offset left;
+  final Offset right;
+  final double pixelsPerCm;
+  final double lengthCm;
+  final double widthCm;
+
+  const FootTrackingFrame({
+    required this.found,
+    required this.isCalibrated,
+    required this.boundingBox,
+    required this.heel,
+    required this.toe,
+    required this.left,
+    required this.right,
+    required this.pixelsPerCm,
+    required this.lengthCm,
+    required this.widthCm,
+  });
+
+  factory FootTrackingFrame.fromNative(List<double> v) => FootTrackingFrame(
+        found: v[0] > 0.5,
+        isCalibrated: v[1] > 0.5,
+        boundingBox: Rect.fromLTWH(v[2], v[3], v[4], v[5]),
+        heel: Offset(v[6], v[7]),
+        toe: Offset(v[8], v[9]),
+        left: Offset(v[10], v[11]),
+        right: Offset(v[12], v[13]),
+        pixelsPerCm: v[14],
+        lengthCm: v[15],
+        widthCm: v[16],
+      );
+
+  List<Offset> get keyPoints => [heel, toe, left, right];
+}
+
+/// Session de suivi du pied sur le flux de prévisualisation (startImageStream).
+/// Les trames sont suivies sur un thread natif dédié; le résultat arrive par onFrame.
+class FootTracker {
+  static CreateFootTrackerWorkerDart? _create;
+  static SubmitFootFrameDart? _submit;
+  static DestroyFootTrackerWorkerDart? _destroy;
+
+  final void Function(FootTrackingFrame frame) _onFrame;
+  late final NativeCallable<FootFrameCallbackNative> _callback;
+  Pointer<Void> _handle = nullptr;
+  final Pointer<Double> _frame = malloc<Double>(FootTrackingFrame.fieldCount);
+  Pointer<Uint8> _yBuffer = nullptr;
+  int _yCapacity = 0;
+  bool _isFrameInFlight = false;
+  bool _disposed = false;
+
+  FootTracker._(this._onFrame) {
+    _callback = NativeCallable<FootFrameCallbackNative>.listener(_onFrameDone);
+  }
+
+  /// Crée une session native, ou null si la bibliothèque ne l'expose pas
+  static FootTracker? create({
+    double qrSizeCm = 3.0,
+    required void Function(FootTrackingFrame frame) onFrame,
+  }) {
+    final lib = OpenCVService.nativeLibrary;
+    if (lib == null) return null;
+
+    try {
+      _create ??= lib.lookupFunction<CreateFootTrackerWorkerNative, CreateFootTrackerWorkerDart>('createFootTrackerWorker');
+      _submit ??= lib.lookupFunction<SubmitFootFrameNative, SubmitFootFrameDart>('submitFootFrame');
+      _destroy ??= lib.lookupFunction<DestroyFootTrackerWorkerNative, DestroyFootTrackerWorkerDart>('destroyFootTrackerWorker');
+    } catch (e) {
+      print('⚠️ Suivi en direct non disponible: $e');
+      return null;
+    }
+
+    final tracker = FootTracker._(onFrame);
+    tracker._handle = _create!(qrSizeCm, tracker._callback.nativeFunction);
+    if (tracker._handle == nullptr) {
+      tracker.dispose();
+      return null;
+    }
+    return tracker;
+  }
+
+  /// Soumet une trame YUV420 (seul le plan Y est transmis). Une seule trame à la fois:
+  /// retourne false, sans copie, si la précédente est encore en cours de suivi.
+  bool submit(CameraImage image, {int rotationDegrees = 0}) {
+    if (_isFrameInFlight || _handle == nullptr || image.format.group != ImageFormatGroup.yuv420) {
+      return false;
+    }
+
+    final yPlane = image.planes[0];
+    final length = yPlane.bytes.length;
+    if (length > _yCapacity) {
+      if (_yBuffer != nullptr) malloc.free(_yBuffer);
+      _yBuffer = malloc<Uint8>(length);
+      _yCapacity = length;
+    }
+    _yBuffer.asTypedList(length).setAll(0, yPlane.bytes);
+
+    // _yBuffer et _frame appartiennent au thread de suivi jusqu'au callback
+    _isFrameInFlight = _submit!(_handle, _yBuffer, image.width, image.height, yPlane.bytesPerRow, rotationDegrees, _frame) != 0;
+    return _isFrameInFlight;
+  }
+
+  void _onFrameDone(int status) {
+    _isFrameInFlight = false;
+    if (_handle == nullptr) return;
+    _onFrame(FootTrackingFrame.fromNative(_frame.asTypedList(FootTrackingFrame.fieldCount)));
+  }
+
+  /// Sans effet si déjà appelé
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    // Destruction avant libération des tampons: attend la trame en cours
+    if (_handle != nullptr) {
+      _destroy!(_handle);
+      _handle = nullptr;
+    }
+    _callback.close();
+    if (_yBuffer != nullptr) {
+      malloc.free(_yBuffer);
+      _yBuffer = nullptr;
+      _yCapacity = 0;
+    }
+    malloc.free(_frame);
+  }
+}
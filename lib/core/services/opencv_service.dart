@@ -1,31 +1,333 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:typed_data';
 import 'dart:io';
 import 'package:ffi/ffi.dart';
-import 'package:path_provider/path_provider.dart';
+import 'package:camera/camera.dart';
 import 'package:flutter/material.dart';
 
 import '../../features/foot_measurement/data/models/foot_measurement.dart';
 
 // Typedefs pour les fonctions natives
+// Les images sont passées en mémoire (pointeur + longueur), décodées côté natif par cv::imdecode.
+// Les images résultat sont cédées sans copie via outHandle et libérées par releaseImageBuffer (NativeFinalizer).
 typedef TestFunctionNative = Int32 Function();
 typedef TestFunctionDart = int Function();
 
-typedef ProcessImageNative = Pointer<Uint8> Function(Pointer<Utf8> path, Pointer<Int32> outSize);
-typedef ProcessImageDart = Pointer<Uint8> Function(Pointer<Utf8> path, Pointer<Int32> outSize);
+typedef ProcessImageNative = Pointer<Uint8> Function(Pointer<Uint8> data, Int32 length, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+typedef ProcessImageDart = Pointer<Uint8> Function(Pointer<Uint8> data, int length, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
 
-typedef RemoveBackgroundNative = Pointer<Uint8> Function(Pointer<Utf8> path, Pointer<Int32> outSize);
-typedef RemoveBackgroundDart = Pointer<Uint8> Function(Pointer<Utf8> path, Pointer<Int32> outSize);
+typedef RemoveBackgroundNative = Pointer<Uint8> Function(Pointer<Uint8> data, Int32 length, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+typedef RemoveBackgroundDart = Pointer<Uint8> Function(Pointer<Uint8> data, int length, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
 
-typedef MeasureFootWithQRNative = Pointer<Uint8> Function(Pointer<Utf8> path, Pointer<Int32> outSize, Double qrSize);
-typedef MeasureFootWithQRDart = Pointer<Uint8> Function(Pointer<Utf8> path, Pointer<Int32> outSize, double qrSize);
+typedef MeasureFootWithQRNative = Pointer<Uint8> Function(Pointer<Uint8> data, Int32 length, Pointer<Int32> outSize, Double qrSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+typedef MeasureFootWithQRDart = Pointer<Uint8> Function(Pointer<Uint8> data, int length, Pointer<Int32> outSize, double qrSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
 
-typedef ExtractFootMeasurementsNative = Pointer<Double> Function(Pointer<Utf8> path, Double qrSize);
-typedef ExtractFootMeasurementsDart = Pointer<Double> Function(Pointer<Utf8> path, double qrSize);
+typedef ExtractFootMeasurementsNative = Int32 Function(Pointer<Uint8> data, Int32 length, Double qrSize, Pointer<FootMeasurementResultStruct> outResult);
+typedef ExtractFootMeasurementsDart = int Function(Pointer<Uint8> data, int length, double qrSize, Pointer<FootMeasurementResultStruct> outResult);
+
+typedef ProcessFootWithQRNative = Pointer<Uint8> Function(Pointer<Uint8> data, Int32 length, Pointer<Int32> outSize, Double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+typedef ProcessFootWithQRDart = Pointer<Uint8> Function(Pointer<Uint8> data, int length, Pointer<Int32> outSize, double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+
+typedef MeasureFootFromYUV420Native = Int32 Function(Pointer<Uint8> yPlane, Int32 width, Int32 height, Int32 yRowStride, Int32 rotationDegrees, Double qrSize, Pointer<FootMeasurementResultStruct> outResult);
+typedef MeasureFootFromYUV420Dart = int Function(Pointer<Uint8> yPlane, int width, int height, int yRowStride, int rotationDegrees, double qrSize, Pointer<FootMeasurementResultStruct> outResult);
+
+typedef CreateMeasurementSessionNative = Pointer<Void> Function(Int32 width, Int32 height);
+typedef CreateMeasurementSessionDart = Pointer<Void> Function(int width, int height);
+
+typedef SessionProcessFootNative = Int32 Function(Pointer<Void> session, Pointer<Uint8> data, Int32 length, Double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<Pointer<Uint8>> outImage, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+typedef SessionProcessFootDart = int Function(Pointer<Void> session, Pointer<Uint8> data, int length, double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<Pointer<Uint8>> outImage, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> options);
+
+typedef DestroyMeasurementSessionNative = Void Function(Pointer<Void> session);
+typedef DestroyMeasurementSessionDart = void Function(Pointer<Void> session);
+
+typedef MeasureFootOverlayNative = Int32 Function(Pointer<Uint8> data, Int32 length, Double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<FootOverlayStruct> outOverlay);
+typedef MeasureFootOverlayDart = int Function(Pointer<Uint8> data, int length, double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<FootOverlayStruct> outOverlay);
+
+typedef SessionMeasureFootOverlayNative = Int32 Function(Pointer<Void> session, Pointer<Uint8> data, Int32 length, Double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<FootOverlayStruct> outOverlay);
+typedef SessionMeasureFootOverlayDart = int Function(Pointer<Void> session, Pointer<Uint8> data, int length, double qrSize, Pointer<FootMeasurementResultStruct> outResult, Pointer<FootOverlayStruct> outOverlay);
+
+typedef FootJobCallbackNative = Void Function(Int64 jobId, Int32 status);
+
+typedef CreateJobQueueNative = Pointer<Void> Function(Int32 workerCount, Pointer<NativeFunction<FootJobCallbackNative>> callback);
+typedef CreateJobQueueDart = Pointer<Void> Function(int workerCount, Pointer<NativeFunction<FootJobCallbackNative>> callback);
+
+typedef SubmitFootJobNative = Int64 Function(Pointer<Void> queue, Pointer<Uint8> data, Int32 length, Double qrSize, Int32 wantImage, Pointer<FootEncodeOptionsStruct> options);
+typedef SubmitFootJobDart = int Function(Pointer<Void> queue, Pointer<Uint8> data, int length, double qrSize, int wantImage, Pointer<FootEncodeOptionsStruct> options);
+
+typedef TakeFootJobResultNative = Int32 Function(Pointer<Void> queue, Int64 jobId, Pointer<FootMeasurementResultStruct> outResult, Pointer<Pointer<Uint8>> outImage, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> outOptions);
+typedef TakeFootJobResultDart = int Function(Pointer<Void> queue, int jobId, Pointer<FootMeasurementResultStruct> outResult, Pointer<Pointer<Uint8>> outImage, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle, Pointer<FootEncodeOptionsStruct> outOptions);
+
+typedef SubmitFootOverlayJobNative = Int64 Function(Pointer<Void> queue, Pointer<Uint8> data, Int32 length, Double qrSize);
+typedef SubmitFootOverlayJobDart = int Function(Pointer<Void> queue, Pointer<Uint8> data, int length, double qrSize);
+
+typedef TakeFootOverlayJobResultNative = Int32 Function(Pointer<Void> queue, Int64 jobId, Pointer<FootMeasurementResultStruct> outResult, Pointer<FootOverlayStruct> outOverlay);
+typedef TakeFootOverlayJobResultDart = int Function(Pointer<Void> queue, int jobId, Pointer<FootMeasurementResultStruct> outResult, Pointer<FootOverlayStruct> outOverlay);
+
+typedef DestroyJobQueueNative = Void Function(Pointer<Void> queue);
+typedef DestroyJobQueueDart = void Function(Pointer<Void> queue);
+
+typedef CreateFootImageNative = Pointer<Void> Function(Pointer<Uint8> data, Int32 length);
+typedef CreateFootImageDart = Pointer<Void> Function(Pointer<Uint8> data, int length);
+
+typedef FootImageMeasureNative = Int32 Function(Pointer<Void> image, Double qrSize, Pointer<FootMeasurementResultStruct> outResult);
+typedef FootImageMeasureDart = int Function(Pointer<Void> image, double qrSize, Pointer<FootMeasurementResultStruct> outResult);
+
+typedef FootImageRenderNative = Pointer<Uint8> Function(Pointer<Void> image, Int32 output, Double qrSize, Pointer<FootEncodeOptionsStruct> options, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle);
+typedef FootImageRenderDart = Pointer<Uint8> Function(Pointer<Void> image, int output, double qrSize, Pointer<FootEncodeOptionsStruct> options, Pointer<Int32> outSize, Pointer<Pointer<Void>> outHandle);
+
+typedef DestroyFootImageNative = Void Function(Pointer<Void> image);
+typedef DestroyFootImageDart = void Function(Pointer<Void> image);
+
+typedef ClearFootImageCacheNative = Void Function();
+typedef ClearFootImageCacheDart = void Function();
+
+typedef SetNativeLogLevelNative = Void Function(Int32 level);
+typedef SetNativeLogLevelDart = void Function(int level);
 
 typedef FreeMemoryNative = Void Function(Pointer<Uint8> ptr);
 typedef FreeMemoryDart = void Function(Pointer<Uint8> ptr);
 
+typedef ReleaseImageBufferNative = Void Function(Pointer<Void> handle);
+
+/// Miroir Dart de FootMeasurementResult (native_opencv.h), version 2.
+/// Alloué côté Dart, rempli par le natif: aucun tableau à libérer côté natif.
+final class FootMeasurementResultStruct extends Struct {
+  static const int qrContentMax = 256;
+  static const int stageCount = 12;
+
+  /// Noms des étapes, dans l'ordre de FootPipelineStage
+  /// ('encode': encodage de l'image résultat, PNG, JPEG ou RGBA selon ImageOutputOptions)
+  static const List<String> stageNames = [
+    'decode', 'qr', 'gray', 'blur', 'threshold', 'morphology',
+    'contours', 'filter', 'measure', 'draw', 'encode', 'total',
+  ];
+
+  @Uint32()
+  external int structSize;
+  @Uint32()
+  external int version;
+
+  @Int32()
+  external int found;
+  @Int32()
+  external int isCalibrated;
+  @Int32()
+  external int imageWidth;
+  @Int32()
+  external int imageHeight;
+  @Int32()
+  external int qrModules;
+  @Int32()
+  external int qrContentLength;
+
+  @Double()
+  external double lengthCm;
+  @Double()
+  external double widthCm;
+  @Double()
+  external double heelToArchCm;
+  @Double()
+  external double archToToeCm;
+  @Double()
+  external double bigToeLengthCm;
+
+  @Double()
+  external double heelX;
+  @Double()
+  external double heelY;
+  @Double()
+  external double toeX;
+  @Double()
+  external double toeY;
+  @Double()
+  external double leftX;
+  @Double()
+  external double leftY;
+  @Double()
+  external double rightX;
+  @Double()
+  external double rightY;
+
+  @Double()
+  external double pixelsPerCm;
+  @Double()
+  external double qrCenterX;
+  @Double()
+  external double qrCenterY;
+  @Double()
+  external double qrSizePixelsRaw;
+  @Double()
+  external double qrSizePixelsCorrected;
+  @Double()
+  external double perspectiveRatio;
+
+  @Array(qrContentMax)
+  external Array<Uint8> qrContent;
+
+  // Version 2: durées de l'appel par étape (ms)
+  @Array(stageCount)
+  external Array<Double> stageMs;
+
+  /// Alloue une structure prête à être remplie (à libérer avec calloc.free)
+  static Pointer<FootMeasurementResultStruct> allocate() {
+    final pointer = calloc<FootMeasurementResultStruct>();
+    pointer.ref.structSize = sizeOf<FootMeasurementResultStruct>();
+    return pointer;
+  }
+
+  FootMeasurement toMeasurement() => FootMeasurement(
+        lengthCm: lengthCm,
+        widthCm: widthCm,
+        heelToArchCm: heelToArchCm,
+        archToToeCm: archToToeCm,
+        bigToeLengthCm: bigToeLengthCm,
+        isCalibrated: isCalibrated != 0,
+      );
+
+  /// Talon, orteil, gauche, droite (pixels de l'image analysée)
+  List<Offset> get keyPoints => [
+        Offset(heelX, heelY),
+        Offset(toeX, toeY),
+        Offset(leftX, leftY),
+        Offset(rightX, rightY),
+      ];
+
+  Rect get boundingBox => Rect.fromLTRB(leftX, toeY, rightX, heelY);
+
+  String? get qrContentText {
+    if (qrContentLength <= 0) return null;
+    final bytes = List<int>.generate(qrContentLength, (i) => qrContent[i]);
+    return utf8.decode(bytes, allowMalformed: true);
+  }
+
+  /// Durées par étape (ms) des étapes exécutées, vide si le natif est en version 1
+  Map<String, double> get stageTimingsMs {
+    if (version < 2) return const {};
+    final timings = <String, double>{};
+    for (var i = 0; i < stageCount; i++) {
+      if (stageMs[i] > 0.0) timings[stageNames[i]] = stageMs[i];
+    }
+    return timings;
+  }
+}
+
+/// Miroir Dart de FootEncodeOptions (native_opencv.h)
+final class FootEncodeOptionsStruct extends Struct {
+  static const int formatPng = 0;
+  static const int formatJpeg = 1;
+  static const int formatRgba = 2;
+
+  @Uint32()
+  external int structSize;
+  @Int32()
+  external int format;
+  @Int32()
+  external int jpegQuality;
+  @Int32()
+  external int pngCompression;
+  @Int32()
+  external int maxDimension;
+  @Int32()
+  external int outputWidth;
+  @Int32()
+  external int outputHeight;
+}
+
+/// Miroir Dart de FootOverlay (native_opencv.h): sommets en pixels de l'image décodée
+final class FootOverlayStruct extends Struct {
+  static const int maxPoints = 1024;
+
+  @Uint32()
+  external int structSize;
+  @Uint32()
+  external int version;
+
+  @Int32()
+  external int imageWidth;
+  @Int32()
+  external int imageHeight;
+  @Int32()
+  external int contourPointCount;
+  @Int32()
+  external int hasQrQuad;
+
+  @Array(8)
+  external Array<Float> keypointsXy;
+  @Array(8)
+  external Array<Float> qrQuadXy;
+  @Array(2 * maxPoints)
+  external Array<Float> contourXy;
+
+  /// Alloue une structure prête à être remplie (à libérer avec calloc.free)
+  static Pointer<FootOverlayStruct> allocate() {
+    final pointer = calloc<FootOverlayStruct>();
+    pointer.ref.structSize = sizeOf<FootOverlayStruct>();
+    return pointer;
+  }
+
+  static List<Offset> _points(Array<Float> xy, int count) =>
+      List<Offset>.generate(count, (i) => Offset(xy[2 * i], xy[2 * i + 1]));
+
+  FootOverlayData toOverlay() => FootOverlayData(
+        imageSize: Size(imageWidth.toDouble(), imageHeight.toDouble()),
+        contour: _points(contourXy, contourPointCount),
+        keyPoints: _points(keypointsXy, 4),
+        qrQuad: hasQrQuad != 0 ? _points(qrQuadXy, 4) : const [],
+      );
+}
+
+/// Superposition à dessiner sur l'image d'origine (coordonnées en pixels de cette image)
+class FootOverlayData {
+  final Size imageSize;
+  final List<Offset> contour;
+
+  /// Talon, orteil, gauche, droite
+  final List<Offset> keyPoints;
+  final List<Offset> qrQuad;
+
+  const FootOverlayData({
+    required this.imageSize,
+    required this.contour,
+    required this.keyPoints,
+    this.qrQuad = const [],
+  });
+}
+
+/// Format et taille des images résultat produites par le natif
+class ImageOutputOptions {
+  final int format;
+  final int jpegQuality;
+  final int pngCompression;
+
+  /// Plus grand côté de l'image produite (0 = pleine résolution)
+  final int maxDimension;
+
+  const ImageOutputOptions.jpeg({this.jpegQuality = 90, this.maxDimension = 0})
+      : format = FootEncodeOptionsStruct.formatJpeg,
+        pngCompression = -1;
+
+  const ImageOutputOptions.png({this.pngCompression = -1, this.maxDimension = 0})
+      : format = FootEncodeOptionsStruct.formatPng,
+        jpegQuality = 0;
+
+  /// Aperçu de l'écran de résultats: JPEG réduit à une taille d'écran de téléphone
+  static const preview = ImageOutputOptions.jpeg(maxDimension: 1600);
+
+  /// Alloue la structure native (à libérer avec calloc.free)
+  Pointer<FootEncodeOptionsStruct> allocate() {
+    final pointer = calloc<FootEncodeOptionsStruct>();
+    pointer.ref
+      ..structSize = sizeOf<FootEncodeOptionsStruct>()
+      ..format = format
+      ..jpegQuality = jpegQuality
+      ..pngCompression = pngCompression
+      ..maxDimension = maxDimension;
+    return pointer;
+  }
+}
+
 class OpenCVService {
   static DynamicLibrary? _lib;
   static TestFunctionDart? _testFunction;
@@ -33,7 +335,40 @@ class OpenCVService {
   static RemoveBackgroundDart? _removeBackground;
   static MeasureFootWithQRDart? _measureFootWithQR;
   static ExtractFootMeasurementsDart? _extractFootMeasurements;
+  static ProcessFootWithQRDart? _processFootWithQR;
+  static MeasureFootFromYUV420Dart? _measureFootFromYUV420;
+  static SessionProcessFootDart? _sessionProcessFoot;
+  static DestroyMeasurementSessionDart? _destroyMeasurementSession;
+  static Pointer<Void> _session = nullptr;
+  static SubmitFootJobDart? _submitFootJob;
+  static TakeFootJobResultDart? _takeFootJobResult;
+  static SubmitFootOverlayJobDart? _submitFootOverlayJob;
+  static TakeFootOverlayJobResultDart? _takeFootOverlayJobResult;
+  static DestroyJobQueueDart? _destroyJobQueue;
+  static NativeCallable<FootJobCallbackNative>? _jobCallback;
+  static Pointer<Void> _jobQueue = nullptr;
+  static final Map<int, Completer<int>> _pendingJobs = {};
+  static MeasureFootOverlayDart? _measureFootOverlay;
+  static SessionMeasureFootOverlayDart? _sessionMeasureFootOverlay;
+  static CreateFootImageDart? _createFootImage;
+  static FootImageMeasureDart? _footImageMeasure;
+  static FootImageRenderDart? _footImageRender;
+  static DestroyFootImageDart? _destroyFootImage;
+  static ClearFootImageCacheDart? _clearFootImageCache;
+  static SetNativeLogLevelDart? _setNativeLogLevel;
   static FreeMemoryDart? _freeMemory;
+  static Pointer<NativeFunction<ReleaseImageBufferNative>>? _releaseImageBuffer;
+
+  /// Niveaux de journalisation native (native_log.h)
+  static const int logLevelDebug = 3;
+  static const int logLevelInfo = 4;
+  static const int logLevelWarn = 5;
+  static const int logLevelError = 6;
+  static const int logLevelSilent = 8;
+
+  /// Sorties d'une image analysée (FootImageOutput, native_opencv.h)
+  static const int _footOutputAnnotated = 0;
+  static const int _footOutputBackgroundRemoved = 1;
 
   static bool _initialized = false;
 
@@ -85,19 +420,107 @@ class OpenCVService {
         print('🧪 Test function OK: $testResult');
         
         // Fonctions de base
-        _processImage = _lib!.lookupFunction<ProcessImageNative, ProcessImageDart>('processImage');
-        _removeBackground = _lib!.lookupFunction<RemoveBackgroundNative, RemoveBackgroundDart>('removeBackground');
+        _processImage = _lib!.lookupFunction<ProcessImageNative, ProcessImageDart>('processImageBuffer');
+        _removeBackground = _lib!.lookupFunction<RemoveBackgroundNative, RemoveBackgroundDart>('removeBackgroundBuffer');
         _freeMemory = _lib!.lookupFunction<FreeMemoryNative, FreeMemoryDart>('freeMemory');
+        _releaseImageBuffer = _lib!.lookup<NativeFunction<ReleaseImageBufferNative>>('releaseImageBuffer');
         print('✅ Fonctions de base liées');
         
         // Nouvelles fonctions QR
         try {
-          _measureFootWithQR = _lib!.lookupFunction<MeasureFootWithQRNative, MeasureFootWithQRDart>('measureFootWithQR');
-          _extractFootMeasurements = _lib!.lookupFunction<ExtractFootMeasurementsNative, ExtractFootMeasurementsDart>('extractFootMeasurements');
+          _measureFootWithQR = _lib!.lookupFunction<MeasureFootWithQRNative, MeasureFootWithQRDart>('measureFootWithQRBuffer');
+          _extractFootMeasurements = _lib!.lookupFunction<ExtractFootMeasurementsNative, ExtractFootMeasurementsDart>('extractFootMeasurementsBuffer');
           print('✅ Fonctions QR robustes liées');
         } catch (e) {
           print('⚠️ Fonctions QR non disponibles: $e');
         }
+
+        // Pipeline fusionné (optionnel)
+        try {
+          _processFootWithQR = _lib!.lookupFunction<ProcessFootWithQRNative, ProcessFootWithQRDart>('processFootWithQRBuffer');
+          print('✅ Pipeline fusionné lié');
+        } catch (e) {
+          print('⚠️ Pipeline fusionné non disponible: $e');
+        }
+
+        // Superposition vectorielle: mesures sans image résultat (optionnelle)
+        try {
+          _measureFootOverlay = _lib!.lookupFunction<MeasureFootOverlayNative, MeasureFootOverlayDart>('measureFootOverlayBuffer');
+          _sessionMeasureFootOverlay = _lib!.lookupFunction<SessionMeasureFootOverlayNative, SessionMeasureFootOverlayDart>('sessionMeasureFootOverlay');
+          print('✅ Superposition vectorielle liée');
+        } catch (e) {
+          print('⚠️ Superposition vectorielle non disponible: $e');
+        }
+
+        // Image analysée: étapes intermédiaires partagées entre sorties (optionnelle)
+        try {
+          _createFootImage = _lib!.lookupFunction<CreateFootImageNative, CreateFootImageDart>('createFootImage');
+          _footImageMeasure = _lib!.lookupFunction<FootImageMeasureNative, FootImageMeasureDart>('footImageMeasure');
+          _footImageRender = _lib!.lookupFunction<FootImageRenderNative, FootImageRenderDart>('footImageRender');
+          _destroyFootImage = _lib!.lookupFunction<DestroyFootImageNative, DestroyFootImageDart>('destroyFootImage');
+          print('✅ Image analysée liée');
+        } catch (e) {
+          _createFootImage = null;
+          print('⚠️ Image analysée non disponible: $e');
+        }
+
+        // Cache natif des images analysées: vidage sur pression mémoire (optionnel)
+        try {
+          _clearFootImageCache = _lib!.lookupFunction<ClearFootImageCacheNative, ClearFootImageCacheDart>('clearFootImageCache');
+        } catch (e) {
+          print('⚠️ Cache d\'images non vidable: $e');
+        }
+
+        // Session persistante: tampons et détecteur QR réutilisés entre captures (optionnelle)
+        try {
+          final createSession = _lib!.lookupFunction<CreateMeasurementSessionNative, CreateMeasurementSessionDart>('createMeasurementSession');
+          _sessionProcessFoot = _lib!.lookupFunction<SessionProcessFootNative, SessionProcessFootDart>('sessionProcessFoot');
+          _destroyMeasurementSession = _lib!.lookupFunction<DestroyMeasurementSessionNative, DestroyMeasurementSessionDart>('destroyMeasurementSession');
+          _session = createSession(0, 0);
+          print('✅ Session de mesure créée');
+        } catch (e) {
+          print('⚠️ Session de mesure non disponible: $e');
+        }
+
+        // File de traitement native (optionnelle): OpenCV hors du thread UI
+        try {
+          final createJobQueue = _lib!.lookupFunction<CreateJobQueueNative, CreateJobQueueDart>('createJobQueue');
+          _submitFootJob = _lib!.lookupFunction<SubmitFootJobNative, SubmitFootJobDart>('submitFootJob');
+          _takeFootJobResult = _lib!.lookupFunction<TakeFootJobResultNative, TakeFootJobResultDart>('takeFootJobResult');
+          _destroyJobQueue = _lib!.lookupFunction<DestroyJobQueueNative, DestroyJobQueueDart>('destroyJobQueue');
+          _jobCallback = NativeCallable<FootJobCallbackNative>.listener(_onJobCompleted);
+          _jobQueue = createJobQueue(0, _jobCallback!.nativeFunction);
+          if (_jobQueue == nullptr) {
+            _jobCallback!.close();
+            _jobCallback = null;
+          }
+          print('✅ File asynchrone ${_jobQueue != nullptr ? "créée" : "indisponible"}');
+        } catch (e) {
+          print('⚠️ File asynchrone non disponible: $e');
+        }
+
+        // Tâches de superposition sur la file (optionnelles)
+        try {
+          _submitFootOverlayJob = _lib!.lookupFunction<SubmitFootOverlayJobNative, SubmitFootOverlayJobDart>('submitFootOverlayJob');
+          _takeFootOverlayJobResult = _lib!.lookupFunction<TakeFootOverlayJobResultNative, TakeFootOverlayJobResultDart>('takeFootOverlayJobResult');
+        } catch (e) {
+          print('⚠️ Superposition asynchrone non disponible: $e');
+        }
+
+        // Entrée caméra YUV420 (optionnelle)
+        try {
+          _measureFootFromYUV420 = _lib!.lookupFunction<MeasureFootFromYUV420Native, MeasureFootFromYUV420Dart>('measureFootFromYUV420');
+          print('✅ Entrée YUV420 liée');
+        } catch (e) {
+          print('⚠️ Entrée YUV420 non disponible: $e');
+        }
+
+        // Niveau de journalisation native à l'exécution (optionnel)
+        try {
+          _setNativeLogLevel = _lib!.lookupFunction<SetNativeLogLevelNative, SetNativeLogLevelDart>('setNativeLogLevel');
+        } catch (e) {
+          print('⚠️ Niveau de journalisation native non réglable: $e');
+        }
         
       } catch (e) {
         print('❌ Erreur liaison fonctions: $e');
@@ -115,49 +538,52 @@ class OpenCVService {
   }
 
   /// Mesure du pied avec QR code robuste
-  static Future<Uint8List?> measureFootWithQR(Uint8List imageBytes, {double qrSizeCm = 3.0}) async {
+  static Future<Uint8List?> measureFootWithQR(
+    Uint8List imageBytes, {
+    double qrSizeCm = 3.0,
+    ImageOutputOptions output = ImageOutputOptions.preview,
+  }) async {
     print('🔍 measureFootWithQR robuste (QR: ${qrSizeCm}cm)');
 
     if (!_initialized) {
       await initialize();
     }
 
+    if (_createFootImage != null) {
+      return _measureFootWithQRGraph(imageBytes, qrSizeCm, output);
+    }
+
     if (_measureFootWithQR == null) {
       print('⚠️ measureFootWithQR non disponible, fallback');
-      return await removeBackground(imageBytes);
+      return await removeBackground(imageBytes, output: output);
     }
 
     try {
-      final tempDir = await getTemporaryDirectory();
-      final tempFile = File('${tempDir.path}/qr_${DateTime.now().millisecondsSinceEpoch}.jpg');
-      await tempFile.writeAsBytes(imageBytes);
-
-      final pathPointer = tempFile.path.toNativeUtf8();
+      final dataPointer = _copyToNative(imageBytes);
       final sizePointer = malloc<Int32>();
+      final handlePointer = malloc<Pointer<Void>>();
+      final optionsPointer = output.allocate();
       
-      final resultPointer = _measureFootWithQR!(pathPointer, sizePointer, qrSizeCm);
+      final resultPointer = _measureFootWithQR!(dataPointer, imageBytes.length, sizePointer, qrSizeCm, handlePointer, optionsPointer);
       final resultSize = sizePointer.value;
+      final handle = handlePointer.value;
+      malloc.free(dataPointer);
+      malloc.free(sizePointer);
+      malloc.free(handlePointer);
+      calloc.free(optionsPointer);
 
       if (resultSize == 0 || resultPointer == nullptr) {
         print('❌ Échec measureFootWithQR, fallback');
-        malloc.free(pathPointer);
-        malloc.free(sizePointer);
-        await tempFile.delete();
-        return await removeBackground(imageBytes);
+        return await removeBackground(imageBytes, output: output);
       }
 
-      final result = Uint8List.fromList(resultPointer.asTypedList(resultSize));
-
-      _freeMemory!(resultPointer);
-      malloc.free(pathPointer);
-      malloc.free(sizePointer);
-      await tempFile.delete();
+      final result = _adoptNativeImage(resultPointer, resultSize, handle);
 
       print('✅ Mesure QR réussie (${result.length} bytes)');
       return result;
     } catch (e) {
       print('❌ Erreur measureFootWithQR: $e');
-      return await removeBackground(imageBytes);
+      return await removeBackground(imageBytes, output: output);
     }
   }
 
@@ -175,42 +601,29 @@ class OpenCVService {
     }
 
     try {
-      final tempDir = await getTemporaryDirectory();
-      final tempFile = File('${tempDir.path}/extract_${DateTime.now().millisecondsSinceEpoch}.jpg');
-      await tempFile.writeAsBytes(imageBytes);
-
-      final pathPointer = tempFile.path.toNativeUtf8();
+      final dataPointer = _copyToNative(imageBytes);
+      final resultPointer = FootMeasurementResultStruct.allocate();
       
-      final resultPointer = _extractFootMeasurements!(pathPointer, qrSizeCm);
+      final found = _extractFootMeasurements!(dataPointer, imageBytes.length, qrSizeCm, resultPointer);
+      malloc.free(dataPointer);
 
-      if (resultPointer == nullptr) {
+      if (found == 0) {
         print('❌ Échec extraction mesures');
-        malloc.free(pathPointer);
-        await tempFile.delete();
+        calloc.free(resultPointer);
         return FootMeasurement.failed();
       }
 
-      // Lecture des 6 valeurs: [length, width, heel_to_arch, arch_to_toe, big_toe, is_calibrated]
-      final measurements = resultPointer.asTypedList(6);
+      final result = resultPointer.ref;
       
       print('📊 Mesures extraites:');
-      print('   Longueur: ${measurements[0].toStringAsFixed(2)}cm');
-      print('   Largeur: ${measurements[1].toStringAsFixed(2)}cm');
-      print('   Calibré: ${measurements[5] > 0.5 ? "OUI" : "NON"}');
+      print('   Longueur: ${result.lengthCm.toStringAsFixed(2)}cm');
+      print('   Largeur: ${result.widthCm.toStringAsFixed(2)}cm');
+      print('   Calibré: ${result.isCalibrated != 0 ? "OUI (${result.pixelsPerCm.toStringAsFixed(1)} px/cm)" : "NON"}');
       
-      final footMeasurement = FootMeasurement(
-        lengthCm: measurements[0],
-        widthCm: measurements[1],
-        heelToArchCm: measurements[2],
-        archToToeCm: measurements[3],
-        bigToeLengthCm: measurements[4],
-        isCalibrated: measurements[5] > 0.5,
-      );
+      final footMeasurement = result.toMeasurement();
 
       // Libération mémoire
-      malloc.free(resultPointer.cast<Void>());
-      malloc.free(pathPointer);
-      await tempFile.delete();
+      calloc.free(resultPointer);
 
       if (!footMeasurement.isValid) {
         print('⚠️ Mesures suspectes: ${footMeasurement.warningMessage}');
@@ -225,12 +638,41 @@ class OpenCVService {
   }
 
   /// Traitement complet avec QR
-  static Future<ProcessingResult?> processFootWithQR(Uint8List imageBytes, {double qrSizeCm = 3.0}) async {
+  static Future<ProcessingResult?> processFootWithQR(
+    Uint8List imageBytes, {
+    double qrSizeCm = 3.0,
+    ImageOutputOptions output = ImageOutputOptions.preview,
+  }) async {
     print('🚀 Traitement complet avec QR');
 
+    if (!_initialized) {
+      await initialize();
+    }
+
+    if (_jobQueue != nullptr) {
+      final jobId = _submitProcessFootJob(imageBytes, qrSizeCm, output);
+      if (jobId != 0) {
+        final queued = await _takeProcessFootJob(jobId);
+        if (queued != null) return queued;
+        // La tâche a laissé son image analysée en cache: le secours ne relance pas le pipeline
+        if (_createFootImage != null) {
+          return _processFootWithQRGraph(imageBytes, qrSizeCm, output);
+        }
+      }
+    }
+
+    if (_session != nullptr || _processFootWithQR != null) {
+      final fused = await _processFootWithQRFused(imageBytes, qrSizeCm, output);
+      if (fused != null) return fused;
+    }
+
+    if (_createFootImage != null) {
+      return _processFootWithQRGraph(imageBytes, qrSizeCm, output);
+    }
+
     try {
       // Traitement image
-      final processedImage = await measureFootWithQR(imageBytes, qrSizeCm: qrSizeCm);
+      final processedImage = await measureFootWithQR(imageBytes, qrSizeCm: qrSizeCm, output: output);
       if (processedImage == null) {
         print('❌ Échec traitement image');
         return null;
@@ -250,38 +692,370 @@ class OpenCVService {
     }
   }
 
-  /// Suppression d'arrière-plan (fallback)
-  static Future<Uint8List?> removeBackground(Uint8List imageBytes) async {
-    print('🔄 removeBackground');
+  static bool get isOverlayAvailable => _measureFootOverlay != null;
+
+  /// Mesures + contour, points clés et QR en vecteurs: l'image d'origine est affichée telle quelle
+  /// et annotée par Flutter (FootContourPainter), sans copie, dessin ni réencodage natifs.
+  /// Sur un worker natif quand la file est disponible; null si aucun pied n'a été mesuré.
+  static Future<ProcessingResult?> processFootWithQROverlay(Uint8List imageBytes, {double qrSizeCm = 3.0}) async {
+    print('🖊️ Traitement QR avec superposition vectorielle');
 
     if (!_initialized) {
       await initialize();
     }
 
+    if (_measureFootOverlay == null) {
+      print('⚠️ Superposition non disponible');
+      return null;
+    }
+
+    try {
+      if (_jobQueue != nullptr && _submitFootOverlayJob != null) {
+        // Tampon cédé à la file, comme pour _submitProcessFootJob
+        final dataPointer = _copyToNative(imageBytes);
+        final jobId = _submitFootOverlayJob!(_jobQueue, dataPointer, imageBytes.length, qrSizeCm);
+        if (jobId != 0) return await _takeFootOverlayQueued(imageBytes, jobId);
+        print('❌ Soumission refusée, superposition synchrone');
+      }
+
+      final dataPointer = _copyToNative(imageBytes);
+      final measurementsPointer = FootMeasurementResultStruct.allocate();
+      final overlayPointer = FootOverlayStruct.allocate();
+
+      final found = _session != nullptr
+          ? _sessionMeasureFootOverlay!(_session, dataPointer, imageBytes.length, qrSizeCm, measurementsPointer, overlayPointer)
+          : _measureFootOverlay!(dataPointer, imageBytes.length, qrSizeCm, measurementsPointer, overlayPointer);
+      malloc.free(dataPointer);
+
+      if (found == 0) {
+        print('❌ Échec superposition');
+        calloc.free(measurementsPointer);
+        calloc.free(overlayPointer);
+        return null;
+      }
+
+      final result = _toProcessingResult(imageBytes, measurementsPointer.ref, overlay: overlayPointer.ref.toOverlay());
+      calloc.free(measurementsPointer);
+      calloc.free(overlayPointer);
+
+      print('✅ Superposition OK (${result.overlay!.contour.length} sommets)');
+      return result;
+    } catch (e) {
+      print('❌ Erreur superposition: $e');
+      return null;
+    }
+  }
+
+  /// Image annotée + mesures en un seul appel natif (un décodage, une détection QR, une segmentation)
+  static Future<ProcessingResult?> _processFootWithQRFused(Uint8List imageBytes, double qrSizeCm, ImageOutputOptions output) async {
+    try {
+      final dataPointer = _copyToNative(imageBytes);
+      final sizePointer = malloc<Int32>();
+      final handlePointer = malloc<Pointer<Void>>();
+      final optionsPointer = output.allocate();
+      final measurementsPointer = FootMeasurementResultStruct.allocate();
+
+      Pointer<Uint8> resultPointer;
+      if (_session != nullptr) {
+        final imagePointer = malloc<Pointer<Uint8>>();
+        _sessionProcessFoot!(_session, dataPointer, imageBytes.length, qrSizeCm, measurementsPointer, imagePointer, sizePointer, handlePointer, optionsPointer);
+        resultPointer = imagePointer.value;
+        malloc.free(imagePointer);
+      } else {
+        resultPointer = _processFootWithQR!(dataPointer, imageBytes.length, sizePointer, qrSizeCm, measurementsPointer, handlePointer, optionsPointer);
+      }
+      final resultSize = sizePointer.value;
+      final handle = handlePointer.value;
+      malloc.free(dataPointer);
+      malloc.free(sizePointer);
+      malloc.free(handlePointer);
+      calloc.free(optionsPointer);
+
+      if (resultSize == 0 || resultPointer == nullptr) {
+        print('❌ Échec pipeline fusionné, fallback');
+        calloc.free(measurementsPointer);
+        return null;
+      }
+
+      final processedImage = _adoptNativeImage(resultPointer, resultSize, handle);
+      final result = _toProcessingResult(processedImage, measurementsPointer.ref);
+      calloc.free(measurementsPointer);
+
+      print('✅ Pipeline fusionné OK (${processedImage.length} bytes)');
+      return result;
+    } catch (e) {
+      print('❌ Erreur pipeline fusionné: $e');
+      return null;
+    }
+  }
+
+  /// Image annotée, ou fond supprimé en secours sur la même image analysée: le secours
+  /// réutilise le décodage, les niveaux de gris, le flou et le seuil d'Otsu déjà calculés
+  /// (flou recalculé pour les grandes images, segmentées en réduit), mais refait son
+  /// propre masque: bord, noyau et filtre d'aire de removeBackground diffèrent de ceux de la
+  /// segmentation du pied
+  static Future<Uint8List?> _measureFootWithQRGraph(Uint8List imageBytes, double qrSizeCm, ImageOutputOptions output) async {
+    final image = _openFootImage(imageBytes);
+    if (image == nullptr) return null;
+
     try {
-      final tempDir = await getTemporaryDirectory();
-      final tempFile = File('${tempDir.path}/bg_${DateTime.now().millisecondsSinceEpoch}.jpg');
-      await tempFile.writeAsBytes(imageBytes);
+      final annotated = _renderFootImage(image, _footOutputAnnotated, qrSizeCm, output);
+      if (annotated != null) {
+        print('✅ Mesure QR réussie (${annotated.length} bytes)');
+        return annotated;
+      }
 
-      final pathPointer = tempFile.path.toNativeUtf8();
+      print('❌ Échec measureFootWithQR, fond supprimé sur la même image');
+      return _renderFootImage(image, _footOutputBackgroundRemoved, qrSizeCm, output);
+    } catch (e) {
+      print('❌ Erreur measureFootWithQR: $e');
+      return null;
+    } finally {
+      _destroyFootImage!(image);
+    }
+  }
+
+  /// Image (annotée, ou fond supprimé sans pied) puis mesures sur une seule image analysée.
+  /// L'image d'abord: le natif décode alors la couleur une seule fois; les mesures sont
+  /// ensuite relues sans recalcul.
+  static Future<ProcessingResult?> _processFootWithQRGraph(Uint8List imageBytes, double qrSizeCm, ImageOutputOptions output) async {
+    final image = _openFootImage(imageBytes);
+    if (image == nullptr) return null;
+
+    final measurementsPointer = FootMeasurementResultStruct.allocate();
+    try {
+      final annotated = _renderFootImage(image, _footOutputAnnotated, qrSizeCm, output);
+      final found = _footImageMeasure!(image, qrSizeCm, measurementsPointer);
+      final processedImage = annotated ?? _renderFootImage(image, _footOutputBackgroundRemoved, qrSizeCm, output);
+      if (processedImage == null) {
+        print('❌ Échec traitement image');
+        return null;
+      }
+
+      if (found == 0) {
+        print('❌ Échec extraction mesures');
+        return ProcessingResult(
+          processedImageBytes: processedImage,
+          measurement: FootMeasurement.failed(),
+          hasQRCalibration: false,
+        );
+      }
+      return _toProcessingResult(processedImage, measurementsPointer.ref);
+    } catch (e) {
+      print('❌ Erreur traitement complet: $e');
+      return null;
+    } finally {
+      calloc.free(measurementsPointer);
+      _destroyFootImage!(image);
+    }
+  }
+
+  /// Image analysée native (copie des octets), à détruire avec _destroyFootImage
+  static Pointer<Void> _openFootImage(Uint8List imageBytes) {
+    final dataPointer = _copyToNative(imageBytes);
+    final image = _createFootImage!(dataPointer, imageBytes.length);
+    malloc.free(dataPointer);
+    return image;
+  }
+
+  /// Une sortie image de l'image analysée; seules les étapes manquantes sont calculées
+  static Uint8List? _renderFootImage(Pointer<Void> image, int kind, double qrSizeCm, ImageOutputOptions output) {
+    final sizePointer = malloc<Int32>();
+    final handlePointer = malloc<Pointer<Void>>();
+    final optionsPointer = output.allocate();
+
+    final resultPointer = _footImageRender!(image, kind, qrSizeCm, optionsPointer, sizePointer, handlePointer);
+    final resultSize = sizePointer.value;
+    final handle = handlePointer.value;
+    malloc.free(sizePointer);
+    malloc.free(handlePointer);
+    calloc.free(optionsPointer);
+
+    if (resultSize == 0 || resultPointer == nullptr) return null;
+    return _adoptNativeImage(resultPointer, resultSize, handle);
+  }
+
+  /// Pipeline sur un worker natif: le thread UI reste libre pendant la mesure.
+  /// Retourne l'identifiant de la tâche, 0 si la file refuse la soumission.
+  static int _submitProcessFootJob(Uint8List imageBytes, double qrSizeCm, ImageOutputOptions output) {
+    try {
+      // Tampon cédé à la file (malloc de package:ffi = malloc C, libéré par free() côté natif)
+      final dataPointer = _copyToNative(imageBytes);
+      final optionsPointer = output.allocate();
+      final jobId = _submitFootJob!(_jobQueue, dataPointer, imageBytes.length, qrSizeCm, 1, optionsPointer);
+      calloc.free(optionsPointer);
+      if (jobId == 0) print('❌ Soumission refusée, fallback');
+      return jobId;
+    } catch (e) {
+      print('❌ Erreur file asynchrone: $e');
+      return 0;
+    }
+  }
+
+  /// Résultat d'une tâche soumise par _submitProcessFootJob; null si la tâche a échoué
+  static Future<ProcessingResult?> _takeProcessFootJob(int jobId) async {
+    try {
+      // Le callback est livré via la boucle d'événements: enregistré avant toute notification
+      final completer = Completer<int>();
+      _pendingJobs[jobId] = completer;
+      await completer.future;
+      if (_jobQueue == nullptr) return null;
+
+      final measurementsPointer = FootMeasurementResultStruct.allocate();
+      final imagePointer = malloc<Pointer<Uint8>>();
       final sizePointer = malloc<Int32>();
-      
-      final resultPointer = _removeBackground!(pathPointer, sizePointer);
+      final handlePointer = malloc<Pointer<Void>>();
+
+      _takeFootJobResult!(_jobQueue, jobId, measurementsPointer, imagePointer, sizePointer, handlePointer, nullptr);
+      final resultPointer = imagePointer.value;
       final resultSize = sizePointer.value;
+      final handle = handlePointer.value;
+      malloc.free(imagePointer);
+      malloc.free(sizePointer);
+      malloc.free(handlePointer);
 
       if (resultSize == 0 || resultPointer == nullptr) {
-        malloc.free(pathPointer);
-        malloc.free(sizePointer);
-        await tempFile.delete();
+        print('❌ Échec tâche $jobId, fallback');
+        calloc.free(measurementsPointer);
         return null;
       }
 
-      final result = Uint8List.fromList(resultPointer.asTypedList(resultSize));
+      final processedImage = _adoptNativeImage(resultPointer, resultSize, handle);
+      final result = _toProcessingResult(processedImage, measurementsPointer.ref);
+      calloc.free(measurementsPointer);
 
-      _freeMemory!(resultPointer);
-      malloc.free(pathPointer);
+      print('✅ Tâche $jobId OK (${processedImage.length} bytes)');
+      return result;
+    } catch (e) {
+      print('❌ Erreur file asynchrone: $e');
+      return null;
+    }
+  }
+
+  /// Attend la fin d'une tâche de superposition puis lit mesures et vecteurs
+  static Future<ProcessingResult?> _takeFootOverlayQueued(Uint8List imageBytes, int jobId) async {
+    final completer = Completer<int>();
+    _pendingJobs[jobId] = completer;
+    await completer.future;
+    if (_jobQueue == nullptr) return null;
+
+    final measurementsPointer = FootMeasurementResultStruct.allocate();
+    final overlayPointer = FootOverlayStruct.allocate();
+    try {
+      final found = _takeFootOverlayJobResult!(_jobQueue, jobId, measurementsPointer, overlayPointer);
+      if (found == 0) {
+        print('❌ Échec superposition (tâche $jobId)');
+        return null;
+      }
+
+      final result = _toProcessingResult(imageBytes, measurementsPointer.ref, overlay: overlayPointer.ref.toOverlay());
+      print('✅ Superposition OK, tâche $jobId (${result.overlay!.contour.length} sommets)');
+      return result;
+    } finally {
+      calloc.free(measurementsPointer);
+      calloc.free(overlayPointer);
+    }
+  }
+
+  static void _onJobCompleted(int jobId, int status) {
+    _pendingJobs.remove(jobId)?.complete(status);
+  }
+
+  static ProcessingResult _toProcessingResult(Uint8List processedImage, FootMeasurementResultStruct details, {FootOverlayData? overlay}) {
+    final measurement = details.toMeasurement();
+    if (!measurement.isValid) {
+      print('⚠️ Mesures suspectes: ${measurement.warningMessage}');
+    }
+
+    return ProcessingResult(
+      processedImageBytes: processedImage,
+      measurement: measurement,
+      boundingBox: details.boundingBox,
+      keyPoints: details.keyPoints,
+      hasQRCalibration: measurement.isCalibrated,
+      qrContent: details.qrContentText,
+      pixelsPerCm: details.pixelsPerCm,
+      stageTimingsMs: details.stageTimingsMs,
+      overlay: overlay,
+    );
+  }
+
+  /// Mesures directement sur une trame caméra YUV420 (plan Y uniquement, sans JPEG)
+  static Future<FootMeasurement> extractFootMeasurementsFromCameraImage(
+    CameraImage image, {
+    double qrSizeCm = 3.0,
+    int rotationDegrees = 0,
+  }) async {
+    if (!_initialized) {
+      await initialize();
+    }
+
+    if (_measureFootFromYUV420 == null || image.format.group != ImageFormatGroup.yuv420) {
+      print('⚠️ Entrée YUV420 non disponible (format: ${image.format.group})');
+      return FootMeasurement.failed();
+    }
+
+    try {
+      final yPlane = image.planes[0];
+      final yPointer = _copyToNative(yPlane.bytes);
+      final measurementsPointer = FootMeasurementResultStruct.allocate();
+
+      final found = _measureFootFromYUV420!(
+        yPointer,
+        image.width,
+        image.height,
+        yPlane.bytesPerRow,
+        rotationDegrees,
+        qrSizeCm,
+        measurementsPointer,
+      );
+      malloc.free(yPointer);
+
+      if (found == 0) {
+        calloc.free(measurementsPointer);
+        return FootMeasurement.failed();
+      }
+
+      final measurement = measurementsPointer.ref.toMeasurement();
+      calloc.free(measurementsPointer);
+
+      return measurement;
+    } catch (e) {
+      print('❌ Erreur mesure YUV420: $e');
+      return FootMeasurement.failed();
+    }
+  }
+
+  /// Suppression d'arrière-plan (fallback)
+  static Future<Uint8List?> removeBackground(
+    Uint8List imageBytes, {
+    ImageOutputOptions output = ImageOutputOptions.preview,
+  }) async {
+    print('🔄 removeBackground');
+
+    if (!_initialized) {
+      await initialize();
+    }
+
+    try {
+      final dataPointer = _copyToNative(imageBytes);
+      final sizePointer = malloc<Int32>();
+      final handlePointer = malloc<Pointer<Void>>();
+      
+      final optionsPointer = output.allocate();
+      final resultPointer = _removeBackground!(dataPointer, imageBytes.length, sizePointer, handlePointer, optionsPointer);
+      final resultSize = sizePointer.value;
+      final handle = handlePointer.value;
+      malloc.free(dataPointer);
       malloc.free(sizePointer);
-      await tempFile.delete();
+      malloc.free(handlePointer);
+      calloc.free(optionsPointer);
+
+      if (resultSize == 0 || resultPointer == nullptr) {
+        return null;
+      }
+
+      final result = _adoptNativeImage(resultPointer, resultSize, handle);
 
       print('✅ removeBackground OK');
       return result;
@@ -292,35 +1066,33 @@ class OpenCVService {
   }
 
   /// Traitement Canny
-  static Future<Uint8List?> processImageCanny(Uint8List imageBytes) async {
+  static Future<Uint8List?> processImageCanny(
+    Uint8List imageBytes, {
+    ImageOutputOptions output = ImageOutputOptions.preview,
+  }) async {
     if (!_initialized) {
       await initialize();
     }
 
     try {
-      final tempDir = await getTemporaryDirectory();
-      final tempFile = File('${tempDir.path}/canny_${DateTime.now().millisecondsSinceEpoch}.jpg');
-      await tempFile.writeAsBytes(imageBytes);
-
-      final pathPointer = tempFile.path.toNativeUtf8();
+      final dataPointer = _copyToNative(imageBytes);
       final sizePointer = malloc<Int32>();
+      final handlePointer = malloc<Pointer<Void>>();
       
-      final resultPointer = _processImage!(pathPointer, sizePointer);
+      final optionsPointer = output.allocate();
+      final resultPointer = _processImage!(dataPointer, imageBytes.length, sizePointer, handlePointer, optionsPointer);
       final resultSize = sizePointer.value;
+      final handle = handlePointer.value;
+      malloc.free(dataPointer);
+      malloc.free(sizePointer);
+      malloc.free(handlePointer);
+      calloc.free(optionsPointer);
 
       if (resultSize == 0 || resultPointer == nullptr) {
-        malloc.free(pathPointer);
-        malloc.free(sizePointer);
-        await tempFile.delete();
         return null;
       }
 
-      final result = Uint8List.fromList(resultPointer.asTypedList(resultSize));
-
-      _freeMemory!(resultPointer);
-      malloc.free(pathPointer);
-      malloc.free(sizePointer);
-      await tempFile.delete();
+      final result = _adoptNativeImage(resultPointer, resultSize, handle);
 
       return result;
     } catch (e) {
@@ -329,6 +1101,25 @@ class OpenCVService {
     }
   }
 
+  /// Copie les octets encodés dans un tampon natif (à libérer avec malloc.free)
+  static Pointer<Uint8> _copyToNative(Uint8List bytes) {
+    final pointer = malloc<Uint8>(bytes.length);
+    pointer.asTypedList(bytes.length).setAll(0, bytes);
+    return pointer;
+  }
+
+  /// Vue Dart sur une image résultat native, sans copie.
+  /// Le tampon natif est libéré par releaseImageBuffer quand la vue est collectée.
+  static Uint8List _adoptNativeImage(Pointer<Uint8> resultPointer, int size, Pointer<Void> handle) {
+    if (handle == nullptr) {
+      // Bibliothèque sans cession de tampon: copie puis freeMemory
+      final copy = Uint8List.fromList(resultPointer.asTypedList(size));
+      _freeMemory!(resultPointer);
+      return copy;
+    }
+    return resultPointer.asTypedList(size, finalizer: _releaseImageBuffer!, token: handle);
+  }
+
   /// Fonction legacy pour compatibilité
   @Deprecated('Utilisez extractFootMeasurements à la place')
   static FootMeasurement? analyzeMeasurement(Uint8List processedImageBytes) {
@@ -343,9 +1134,25 @@ class OpenCVService {
 
   static bool get isInitialized => _initialized;
 
+  /// Bibliothèque native chargée (partagée avec FootTracker)
+  static DynamicLibrary? get nativeLibrary => _lib;
+
   /// Nettoyage des ressources
+  /// Règle le niveau minimal des journaux natifs (logLevelDebug ... logLevelSilent).
+  /// Les niveaux exclus à la compilation (release: erreurs seules) restent muets.
+  static void setNativeLogLevel(int level) {
+    _setNativeLogLevel?.call(level);
+  }
+
+  /// Libère les images analysées gardées par le cache natif (captures récentes).
+  /// À appeler sur pression mémoire; une capture rouverte ensuite est recalculée.
+  static void clearImageCache() {
+    _clearFootImageCache?.call();
+  }
+
   static void dispose() {
     print('🧹 Nettoyage OpenCV Service');
+    clearImageCache();
     _initialized = false;
     _lib = null;
     _testFunction = null;
@@ -353,7 +1160,40 @@ class OpenCVService {
     _removeBackground = null;
     _measureFootWithQR = null;
     _extractFootMeasurements = null;
+    _processFootWithQR = null;
+    _measureFootFromYUV420 = null;
+    // Destruction avant fermeture du callback: les workers peuvent encore l'appeler
+    if (_jobQueue != nullptr) {
+      _destroyJobQueue!(_jobQueue);
+      _jobQueue = nullptr;
+    }
+    _jobCallback?.close();
+    _jobCallback = null;
+    for (final completer in _pendingJobs.values) {
+      completer.complete(0);
+    }
+    _pendingJobs.clear();
+    _submitFootJob = null;
+    _takeFootJobResult = null;
+    _submitFootOverlayJob = null;
+    _takeFootOverlayJobResult = null;
+    _destroyJobQueue = null;
+    if (_session != nullptr) {
+      _destroyMeasurementSession!(_session);
+      _session = nullptr;
+    }
+    _sessionProcessFoot = null;
+    _destroyMeasurementSession = null;
+    _measureFootOverlay = null;
+    _sessionMeasureFootOverlay = null;
+    _createFootImage = null;
+    _footImageMeasure = null;
+    _footImageRender = null;
+    _destroyFootImage = null;
+    _clearFootImageCache = null;
+    _setNativeLogLevel = null;
     _freeMemory = null;
+    _releaseImageBuffer = null;
   }
 }
 
@@ -364,6 +1204,12 @@ class ProcessingResult {
   final Rect? boundingBox;
   final List<Offset>? keyPoints;
   final bool hasQRCalibration;
+  final String? qrContent;
+  final double pixelsPerCm;
+  final Map<String, double> stageTimingsMs;
+
+  /// Mode superposition: processedImageBytes est l'image d'origine, à annoter avec overlay
+  final FootOverlayData? overlay;
   final DateTime processedAt;
 
   ProcessingResult({
@@ -372,6 +1218,10 @@ class ProcessingResult {
     this.boundingBox,
     this.keyPoints,
     this.hasQRCalibration = false,
+    this.qrContent,
+    this.pixelsPerCm = 0.0,
+    this.stageTimingsMs = const {},
+    this.overlay,
   }) : processedAt = DateTime.now();
 
   bool get isValid => measurement.isValid;
@@ -397,6 +1247,8 @@ class ProcessingResult {
   Map<String, dynamic> toJson() => {
     'measurement': measurement.toJson(),
     'hasQRCalibration': hasQRCalibration,
+    'pixelsPerCm': pixelsPerCm,
+    'stageTimingsMs': stageTimingsMs,
     'processedAt': processedAt.toIso8601String(),
     'isValid': isValid,
   };
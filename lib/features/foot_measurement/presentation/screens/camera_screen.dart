@@ -3,7 +3,9 @@ import 'package:flutter/material.dart';
 import 'package:camera/camera.dart';
 import 'results_screen.dart';
 import '../../../../core/services/opencv_service.dart';
+import '../../../../core/services/foot_tracking_service.dart';
 import '../../data/models/foot_measurement.dart';
+import '../widgets/foot_points_painter.dart';
 
 class CameraScreen extends StatefulWidget {
   final CameraDescription camera;
@@ -20,6 +22,11 @@ class _CameraScreenState extends State<CameraScreen> {
   double _qrSizeCm = 3.0; // Taille par défaut du QR en cm
   bool _useQRMode = true;
 
+  // Suivi en direct sur le flux de prévisualisation
+  FootTracker? _tracker;
+  FootTrackingFrame? _liveFrame;
+  bool _isLiveTracking = false;
+
   @override
   void initState() {
     super.initState();
@@ -31,6 +38,9 @@ class _CameraScreenState extends State<CameraScreen> {
     _controller = CameraController(
       widget.camera,
       ResolutionPreset.high,
+      enableAudio: false,
+      // Trames YUV420 brutes: le natif lit directement le plan Y
+      imageFormatGroup: ImageFormatGroup.yuv420,
     );
     await _controller.initialize();
     setState(() => _isCameraInitialized = true);
@@ -51,11 +61,58 @@ class _CameraScreenState extends State<CameraScreen> {
 
   @override
   void dispose() {
+    if (_isLiveTracking) {
+      _controller.stopImageStream();
+    }
+    _tracker?.dispose();
     _controller.dispose();
     super.dispose();
   }
 
+  Future<void> _startLiveTracking() async {
+    _tracker?.dispose();
+    _tracker = FootTracker.create(qrSizeCm: _qrSizeCm, onFrame: _onTrackedFrame);
+    if (_tracker == null) {
+      _showError('Suivi en direct non disponible');
+      return;
+    }
+
+    await _controller.startImageStream(_onPreviewFrame);
+    setState(() => _isLiveTracking = true);
+  }
+
+  Future<void> _stopLiveTracking() async {
+    if (_isLiveTracking) {
+      await _controller.stopImageStream();
+    }
+    _tracker?.dispose();
+    _tracker = null;
+    if (!mounted) return;
+    setState(() {
+      _isLiveTracking = false;
+      _liveFrame = null;
+    });
+  }
+
+  void _onPreviewFrame(CameraImage image) {
+    // Suivi hors du thread UI; les trames arrivées pendant le suivi de la précédente sont ignorées
+    _tracker?.submit(
+      image,
+      rotationDegrees: widget.camera.sensorOrientation,
+    );
+  }
+
+  void _onTrackedFrame(FootTrackingFrame frame) {
+    if (!mounted) return;
+    setState(() => _liveFrame = frame);
+  }
+
   Future<void> _captureAndProcess() async {
+    // La capture photo n'est pas disponible pendant le flux d'images
+    if (_isLiveTracking) {
+      await _stopLiveTracking();
+    }
+
     setState(() => _isProcessing = true);
 
     try {
@@ -67,10 +124,14 @@ class _CameraScreenState extends State<CameraScreen> {
       if (_useQRMode && OpenCVService.isQRFunctionsAvailable) {
         // Mode QR: traitement complet avec calibration
         print('🎯 Mode QR activé');
-        final result = await OpenCVService.processFootWithQR(
-          imageBytes, 
-          qrSizeCm: _qrSizeCm
-        );
+        // Superposition vectorielle si disponible: ni annotation ni réencodage natifs.
+        // Sans pied mesuré, pas de second pipeline: le secours sans QR prend le relais.
+        final result = OpenCVService.isOverlayAvailable
+            ? await OpenCVService.processFootWithQROverlay(imageBytes, qrSizeCm: _qrSizeCm)
+            : await OpenCVService.processFootWithQR(
+                imageBytes, 
+                qrSizeCm: _qrSizeCm
+              );
 
         if (result == null) {
           _showErrorAndFallback('Échec du traitement avec QR', imageBytes);
@@ -85,6 +146,7 @@ class _CameraScreenState extends State<CameraScreen> {
               originalImage: imageBytes,
               processedImage: result.processedImageBytes,
               measurement: result.measurement,
+              overlay: result.overlay,
             ),
           ),
         );
@@ -180,6 +242,10 @@ class _CameraScreenState extends State<CameraScreen> {
                 setState(() {
                   _qrSizeCm = value ?? 3.0;
                 });
+                if (_isLiveTracking) {
+                  _tracker?.dispose();
+                  _tracker = FootTracker.create(qrSizeCm: _qrSizeCm, onFrame: _onTrackedFrame);
+                }
                 Navigator.pop(context);
               },
             ),
@@ -205,6 +271,16 @@ class _CameraScreenState extends State<CameraScreen> {
               children: [
                 // Prévisualisation de la caméra
                 CameraPreview(_controller),
+
+                // Suivi en direct du pied
+                if (_isLiveTracking && _liveFrame != null && _liveFrame!.found)
+                  CustomPaint(
+                    painter: FootOverlayPainter(
+                      box: _liveFrame!.boundingBox,
+                      screenSize: MediaQuery.of(context).size,
+                      points: _liveFrame!.keyPoints,
+                    ),
+                  ),
                 
                 // Overlay avec instructions
                 Positioned(
@@ -240,6 +316,16 @@ class _CameraScreenState extends State<CameraScreen> {
                             ),
                           ],
                         ),
+                        if (_isLiveTracking && _liveFrame != null)
+                          Text(
+                            _liveFrame!.found
+                                ? 'Pied détecté • L ${_liveFrame!.lengthCm.toStringAsFixed(1)}cm • ${_liveFrame!.isCalibrated ? "QR calibré" : "QR non détecté"}'
+                                : 'Aucun pied détecté',
+                            style: TextStyle(
+                              color: _liveFrame!.found ? Colors.green : Colors.orange,
+                              fontSize: 12,
+                            ),
+                          ),
                         if (!OpenCVService.isQRFunctionsAvailable)
                           const Text(
                             'Fonctions QR non disponibles - Mode compatibilité',
@@ -314,6 +400,22 @@ class _CameraScreenState extends State<CameraScreen> {
                         label: Text(_isProcessing ? "Traitement..." : "Scanner le pied"),
                       ),
 
+                      // Suivi en direct
+                      FloatingActionButton(
+                        heroTag: "live_tracking",
+                        mini: true,
+                        backgroundColor: _isLiveTracking
+                            ? Colors.blue.withOpacity(0.9)
+                            : Colors.white.withOpacity(0.9),
+                        onPressed: _isProcessing
+                            ? null
+                            : (_isLiveTracking ? _stopLiveTracking : _startLiveTracking),
+                        child: Icon(
+                          _isLiveTracking ? Icons.visibility : Icons.visibility_off,
+                          color: _isLiveTracking ? Colors.white : Colors.black,
+                        ),
+                      ),
+
                       // Toggle mode QR/Estimation
                       if (OpenCVService.isQRFunctionsAvailable)
                         FloatingActionButton(
@@ -1,17 +1,23 @@
 import 'dart:typed_data';
 import 'package:flutter/material.dart';
+import '../../../../core/services/opencv_service.dart';
 import '../../data/models/foot_measurement.dart';
+import '../widgets/foot_points_painter.dart';
 
 class ResultsScreen extends StatelessWidget {
   final Uint8List originalImage;
   final Uint8List processedImage;
   final FootMeasurement measurement;
 
+  /// Superposition vectorielle: processedImage est alors l'image d'origine, annotée à l'affichage
+  final FootOverlayData? overlay;
+
   const ResultsScreen({
     super.key,
     required this.originalImage,
     required this.processedImage,
     required this.measurement,
+    this.overlay,
   });
 
   @override
@@ -152,11 +158,17 @@ class ResultsScreen extends StatelessWidget {
               const SizedBox(height: 8),
               ClipRRect(
                 borderRadius: BorderRadius.circular(8),
-                child: Image.memory(
-                  processedImage, 
-                  fit: BoxFit.cover,
+                child: SizedBox(
                   height: 200,
                   width: double.infinity,
+                  child: Stack(
+                    fit: StackFit.expand,
+                    children: [
+                      Image.memory(processedImage, fit: BoxFit.cover),
+                      if (overlay != null)
+                        CustomPaint(painter: FootContourPainter(overlay: overlay!)),
+                    ],
+                  ),
                 ),
               ),
             ],
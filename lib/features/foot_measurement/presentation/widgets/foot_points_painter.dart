@@ -1,14 +1,19 @@
+import 'dart:math' as math;
 import 'dart:ui' as ui;
 
 import 'package:flutter/cupertino.dart'; // Alias ajouté
 
+import '../../../../core/services/opencv_service.dart';
+
 class FootOverlayPainter extends CustomPainter {
   final Rect box;
   final ui.Size screenSize;
+  final List<Offset> points;
 
   FootOverlayPainter({
     required this.box,
     required this.screenSize,
+    this.points = const [],
   });
 
   @override
@@ -27,8 +32,71 @@ class FootOverlayPainter extends CustomPainter {
     );
 
     canvas.drawRect(scaledBox, paint);
+
+    // Points extrêmes (talon, orteil, gauche, droite)
+    final pointPaint = ui.Paint()
+      ..color = const ui.Color(0xFFFFFF00)
+      ..style = ui.PaintingStyle.fill;
+
+    for (final point in points) {
+      canvas.drawCircle(
+        Offset(point.dx * screenSize.width, point.dy * screenSize.height),
+        6,
+        pointPaint,
+      );
+    }
   }
 
   @override
   bool shouldRepaint(covariant CustomPainter oldDelegate) => true;
-}
\ No newline at end of file
+}
+
+/// Superposition vectorielle (contour, points clés, QR) sur une image affichée en BoxFit.cover.
+/// Les coordonnées de [overlay] sont en pixels de l'image d'origine.
+class FootContourPainter extends CustomPainter {
+  final FootOverlayData overlay;
+
+  FootContourPainter({required this.overlay});
+
+  @override
+  void paint(ui.Canvas canvas, ui.Size size) {
+    final imageSize = overlay.imageSize;
+    if (imageSize.isEmpty) return;
+
+    // Même transformation que BoxFit.cover: échelle max, image centrée
+    final scale = math.max(size.width / imageSize.width, size.height / imageSize.height);
+    final dx = (size.width - imageSize.width * scale) / 2;
+    final dy = (size.height - imageSize.height * scale) / 2;
+    Offset map(Offset p) => Offset(p.dx * scale + dx, p.dy * scale + dy);
+
+    if (overlay.contour.length > 1) {
+      final contourPaint = ui.Paint()
+        ..color = const ui.Color(0xFF00FF00)
+        ..strokeWidth = 2
+        ..style = ui.PaintingStyle.stroke;
+      canvas.drawPath(ui.Path()..addPolygon(overlay.contour.map(map).toList(), true), contourPaint);
+    }
+
+    if (overlay.qrQuad.length == 4) {
+      final qrPaint = ui.Paint()
+        ..color = const ui.Color(0xFF2196F3)
+        ..strokeWidth = 2
+        ..style = ui.PaintingStyle.stroke;
+      canvas.drawPath(ui.Path()..addPolygon(overlay.qrQuad.map(map).toList(), true), qrPaint);
+    }
+
+    // Talon, orteil, gauche, droite
+    const colors = [
+      ui.Color(0xFFFFFF00),
+      ui.Color(0xFFFF3200),
+      ui.Color(0xFF0032FF),
+      ui.Color(0xFF00FFFF),
+    ];
+    for (var i = 0; i < overlay.keyPoints.length && i < colors.length; i++) {
+      canvas.drawCircle(map(overlay.keyPoints[i]), 4, ui.Paint()..color = colors[i]);
+    }
+  }
+
+  @override
+  bool shouldRepaint(covariant FootContourPainter oldDelegate) => oldDelegate.overlay != overlay;
+}
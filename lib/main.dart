@@ -2,6 +2,7 @@ import 'package:flutter/material.dart';
 import 'package:camera/camera.dart';
 import 'features/foot_measurement/presentation/screens/camera_screen.dart';
 import 'config/theme.dart';
+import 'core/services/opencv_service.dart';
 
 Future<void> main() async {
   WidgetsFlutterBinding.ensureInitialized();
@@ -20,18 +21,43 @@ Future<void> main() async {
   }
 }
 
-class FootMeasurementApp extends StatelessWidget {
+class FootMeasurementApp extends StatefulWidget {
   final CameraDescription camera;
 
   const FootMeasurementApp({super.key, required this.camera});
 
+  @override
+  State<FootMeasurementApp> createState() => _FootMeasurementAppState();
+}
+
+class _FootMeasurementAppState extends State<FootMeasurementApp>
+    with WidgetsBindingObserver {
+  @override
+  void initState() {
+    super.initState();
+    WidgetsBinding.instance.addObserver(this);
+  }
+
+  @override
+  void dispose() {
+    WidgetsBinding.instance.removeObserver(this);
+    super.dispose();
+  }
+
+  // Le système manque de mémoire: les images analysées en cache se recalculent au besoin
+  @override
+  void didHaveMemoryPressure() {
+    print('⚠️ Pression mémoire: vidage du cache d\'images');
+    OpenCVService.clearImageCache();
+  }
+
   @override
   Widget build(BuildContext context) {
     return MaterialApp(
       title: 'SOLOL Foot Measurement',
       theme: AppTheme.lightTheme,
       debugShowCheckedModeBanner: false,
-      home: CameraScreen(camera: camera), // Passage de la caméra
+      home: CameraScreen(camera: widget.camera), // Passage de la caméra
     );
   }
 }
\ No newline at end of file